@@ -0,0 +1,38 @@
+#include "allocation_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<size_t> allocation_count { 0 };
+}
+
+// The array and nothrow forms call these, so every allocation is counted
+void* operator new(size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t /*size*/) noexcept
+{
+	std::free(memory);
+}
+
+namespace demo
+{
+	size_t get_allocation_count()
+	{
+		return allocation_count.load(std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace demo
+{
+	// Get the number of heap allocations made through the global operator new on any thread
+	// Used by the benchmarks to check that stepping a world doesn't allocate
+	size_t get_allocation_count();
+
+	// The counter replaces the demo's global operator new, so it only sees engine allocations when the engine is linked statically
+	// The x64 configurations link the engine as a static library, the Win32 configurations load it as a DLL with its own operator new
+#if defined(_WIN32) && !defined(_WIN64)
+	constexpr bool counts_engine_allocations = false;
+#else
+	constexpr bool counts_engine_allocations = true;
+#endif
+}
\ No newline at end of file
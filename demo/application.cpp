@@ -22,6 +22,10 @@ namespace demo
 			return std::move(std::make_unique<demo::dynamics_problem_scene>(world));
 		}});
 
+		scenes.push_back({ "Benchmark", [&] {
+			return std::move(std::make_unique<demo::benchmark_scene>(world));
+		}});
+
 		set_scene(0);
 	}
 
@@ -31,6 +35,7 @@ namespace demo
 		world.clear();
 
 		world.set_gravity(world_gravity);
+		world.set_n_body_settings({});
 
 		scene_index = index;
 		scene = std::move(scenes[index].create_scene());
@@ -125,12 +130,115 @@ namespace demo
 				{
 					iterations_per_frame = std::max(temp_iterations_per_frame, 1);
 				}
+				ImGui::NewLine();
+
+				int temp_thread_count = static_cast<int>(world.get_thread_count());
+				ImGui::Text("Threads");
+				if (ImGui::InputInt("##Threads", &temp_thread_count, 1, 1, ImGuiInputTextFlags_EnterReturnsTrue))
+				{
+					world.set_thread_count(std::max(temp_thread_count, 1));
+				}
+				ImGui::NewLine();
+
+				physics::contact_solver_settings solver_settings = world.get_solver_settings();
+				ImGui::Text("Velocity iterations");
+				if (ImGui::InputInt("##VelocityIterations", &solver_settings.velocity_iterations, 1, 1, ImGuiInputTextFlags_EnterReturnsTrue))
+				{
+					solver_settings.velocity_iterations = std::max(solver_settings.velocity_iterations, 1);
+					world.set_solver_settings(solver_settings);
+				}
+				if (ImGui::Checkbox("Warm starting", &solver_settings.warm_starting))
+				{
+					world.set_solver_settings(solver_settings);
+				}
+				ImGui::NewLine();
+
+				physics::sleep_settings sleep_settings = world.get_sleep_settings();
+				if (ImGui::Checkbox("Sleep resting bodies", &sleep_settings.enabled))
+				{
+					world.set_sleep_settings(sleep_settings);
+				}
+
+				bool skip_unchanged_shapes = world.get_skip_unchanged_shapes();
+				if (ImGui::Checkbox("Skip unchanged shapes", &skip_unchanged_shapes))
+				{
+					world.set_skip_unchanged_shapes(skip_unchanged_shapes);
+				}
+
+				bool deterministic = world.get_deterministic();
+				if (ImGui::Checkbox("Deterministic", &deterministic))
+				{
+					world.set_deterministic(deterministic);
+				}
+				if (deterministic)
+				{
+					ImGui::Text("State hash: %016llx", static_cast<unsigned long long>(world.get_state_hash()));
+				}
+				ImGui::NewLine();
+
+				physics::n_body_settings n_body_settings = world.get_n_body_settings();
+				if (n_body_settings.enabled)
+				{
+					bool barnes_hut = n_body_settings.mode == physics::n_body_mode::barnes_hut;
+					if (ImGui::Checkbox("Barnes-Hut gravity", &barnes_hut))
+					{
+						n_body_settings.mode = barnes_hut ? physics::n_body_mode::barnes_hut : physics::n_body_mode::exact;
+						world.set_n_body_settings(n_body_settings);
+					}
+
+					ImGui::Text("Opening angle");
+					if (ImGui::InputDouble("##OpeningAngle", &n_body_settings.opening_angle, 0.05, 0, "%.2f", ImGuiInputTextFlags_EnterReturnsTrue))
+					{
+						n_body_settings.opening_angle = std::max(n_body_settings.opening_angle, 0.0);
+						world.set_n_body_settings(n_body_settings);
+					}
+					ImGui::NewLine();
+				}
+
+				ImGui::Text("Broad phase");
+				if (ImGui::Selectable("Uniform Grid", world.get_broad_phase() == physics::broad_phase_type::uniform_grid))
+				{
+					world.set_broad_phase(physics::broad_phase_type::uniform_grid);
+				}
+				if (ImGui::Selectable("Dynamic AABB Tree", world.get_broad_phase() == physics::broad_phase_type::dynamic_tree))
+				{
+					world.set_broad_phase(physics::broad_phase_type::dynamic_tree);
+				}
+				if (ImGui::Selectable("Sweep and Prune", world.get_broad_phase() == physics::broad_phase_type::sweep_and_prune))
+				{
+					world.set_broad_phase(physics::broad_phase_type::sweep_and_prune);
+				}
+				if (ImGui::Selectable("Brute Force", world.get_broad_phase() == physics::broad_phase_type::brute_force))
+				{
+					world.set_broad_phase(physics::broad_phase_type::brute_force);
+				}
 
 				ImGui::PopItemWidth();
 
 				ImGui::EndTabItem();
 			}
 
+			if (ImGui::BeginTabItem("Performance"))
+			{
+				ImGui::Text("Bodies: %zu", world.get_body_count());
+				ImGui::Text("Sleeping bodies: %zu", performance_report.sleeping_body_count);
+				ImGui::Text("Shapes refreshed: %zu", performance_report.refreshed_shape_count);
+				ImGui::NewLine();
+
+				ImGui::Text("Broad phase: %.3fms", performance_report.broad_phase_time);
+				ImGui::Text("Narrow phase: %.3fms", performance_report.narrow_phase_time);
+				ImGui::Text("Solve constraints: %.3fms", performance_report.solve_constraints_time);
+				ImGui::Text("Integrate motion: %.3fms", performance_report.integrate_motion_time);
+				ImGui::Text("N-body gravity: %.3fms", performance_report.n_body_time);
+				ImGui::Text("Force generators: %.3fms", performance_report.apply_forces_time);
+				ImGui::NewLine();
+
+				ImGui::Text("Islands: %zu", performance_report.island_count);
+				ImGui::Text("Largest island: %zu bodies", performance_report.largest_island);
+
+				ImGui::EndTabItem();
+			}
+
 			ImGui::EndTabBar();
 		}
 
@@ -310,12 +418,12 @@ namespace demo
 			{
 				for (const auto& contact : world.get_contacts())
 				{
-					for (const auto& collision_point : contact.contact_points)
+					for (size_t i = 0; i < contact.point_count; i++)
 					{
 						sf::RectangleShape rect{ {5, 5} };
 						rect.setFillColor(sf::Color::Green);
 						rect.setOrigin(rect.getSize() / 2.0f);
-						rect.setPosition(world_to_screen(collision_point));
+						rect.setPosition(world_to_screen(contact.contact_points[i]));
 						window.draw(rect);
 					}
 				}
@@ -5,16 +5,31 @@ namespace demo
 {
 	void polygon_object::build_polygon(float scale)
 	{
-		if (body == nullptr || body->get_shape() == nullptr || body->get_shape()->get_type() != physics::shape_type::polygon)
+		if (body == nullptr || body->get_shape() == nullptr)
 			return;
 
-		const std::vector<physics::vec_2d>& vertices = static_cast<const physics::polygon*>(body->get_shape())->get_vertices();
+		physics::shape_type type = body->get_shape()->get_type();
 
-		polygon.setPointCount(vertices.size());
+		if (type != physics::shape_type::polygon && type != physics::shape_type::rounded_polygon)
+			return;
+
+		const physics::vertex_array& vertices = static_cast<const physics::polygon*>(body->get_shape())->get_vertices();
+
+		// Rounded polygons are drawn from their outline
+		std::vector<physics::vec_2d> outline {};
+		std::span<const physics::vec_2d> points = vertices;
+
+		if (type == physics::shape_type::rounded_polygon)
+		{
+			physics::get_rounded_outline(vertices, static_cast<const physics::rounded_polygon*>(body->get_shape())->get_radius(), 8, outline);
+			points = outline;
+		}
+
+		polygon.setPointCount(points.size());
 
-		for (int point_index = 0; point_index < vertices.size(); point_index++)
+		for (int point_index = 0; point_index < points.size(); point_index++)
 		{
-			physics::vec_2d vertex = vertices[point_index];
+			physics::vec_2d vertex = points[point_index];
 			polygon.setPoint(point_index, sf::Vector2f{ static_cast<float>(vertex.x * scale), -static_cast<float>(vertex.y * scale) });
 		}
 
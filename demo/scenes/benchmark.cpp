@@ -0,0 +1,368 @@
+#include "benchmark.h"
+#include "../allocation_counter.h"
+#include "../random.h"
+
+namespace demo
+{
+	benchmark_scene::benchmark_scene(physics::world& world)
+		: scene(world)
+	{
+		allow_zoom = false;
+		allow_pan = false;
+	}
+
+	void benchmark_scene::start()
+	{
+	}
+
+	void benchmark_scene::run_integrator_benchmark()
+	{
+		integrator_results.clear();
+
+		physics::simd_level supported_level = physics::get_supported_simd_level();
+		physics::vec_2d gravity = world.get_gravity();
+		double dt = 1.0 / 60.0;
+
+		for (size_t body_count : { 10000, 100000, 1000000 })
+		{
+			integrator_result result;
+			result.body_count = body_count;
+
+			// Fill storage with moving dynamic bodies
+			physics::body_storage storage;
+			for (size_t i = 0; i < body_count; i++)
+			{
+				size_t index = storage.add();
+				storage.set_velocity(index, { 1.0, 2.0 });
+				storage.angular_velocity[index] = 0.5;
+				storage.inv_mass[index] = 1.0;
+				storage.motion_mask[index] = 1.0;
+			}
+
+			for (int level = 0; level <= static_cast<int>(supported_level); level++)
+			{
+				physics::timer timer;
+
+				for (int step = 0; step < integrator_steps; step++)
+					physics::integrate_motion(storage, gravity, dt, static_cast<physics::simd_level>(level));
+
+				double seconds = timer.elapsed<std::chrono::nanoseconds>() / 1e9;
+				result.bodies_per_second[level] = body_count * integrator_steps / seconds;
+			}
+
+			integrator_results.push_back(result);
+		}
+	}
+
+	void benchmark_scene::run_step_benchmark()
+	{
+		step_results.clear();
+
+		for (bool circles : { true, false })
+		{
+			step_result result;
+			result.name = circles ? "Circles" : "Boxes";
+
+			physics::world step_world;
+			step_world.set_thread_count(world.get_thread_count());
+
+			// Keep every body awake so the whole pipeline runs each step
+			physics::sleep_settings sleep_settings = step_world.get_sleep_settings();
+			sleep_settings.enabled = false;
+			step_world.set_sleep_settings(sleep_settings);
+
+			physics::material material;
+			material.restitution = 0.0;
+
+			step_world.create_body(physics::make_rect(200, 1), material, physics::static_body, { 0, -0.5 });
+
+			// Columns of touching bodies resting on the ground
+			for (int column = 0; column < 50; column++)
+			{
+				for (int row = 0; row < 5; row++)
+				{
+					physics::vec_2d position { -75.0 + column * 3.0, 0.5 + row };
+
+					if (circles)
+						step_world.create_body(physics::make_circle(0.5), material, physics::dynamic_body, position);
+					else
+						step_world.create_body(physics::make_rect(1, 1), material, physics::dynamic_body, position);
+				}
+			}
+
+			for (int step = 0; step < settle_steps; step++)
+				step_world.step(1.0 / 60.0, 1);
+
+			size_t allocations = get_allocation_count();
+			physics::timer timer;
+
+			for (int step = 0; step < measured_steps; step++)
+				step_world.step(1.0 / 60.0, 1);
+
+			double milliseconds = timer.elapsed<std::chrono::microseconds>() / 1000.0;
+
+			result.body_count = step_world.get_body_count();
+			result.contact_count = step_world.get_contacts().size();
+			result.milliseconds_per_step = milliseconds / measured_steps;
+			result.allocations_per_step = static_cast<double>(get_allocation_count() - allocations) / measured_steps;
+
+			step_results.push_back(result);
+		}
+	}
+
+	void benchmark_scene::run_narrow_phase_benchmark()
+	{
+		narrow_phase_results.clear();
+
+		// Boxes and circles take the SAT paths, capsules, rounded boxes and large polygons take GJK
+		using make_shape = physics::shape_ptr (*)();
+
+		struct narrow_phase_test
+		{
+			const char* name;
+			make_shape make_a;
+			make_shape make_b;
+		};
+
+		make_shape box = [] { return physics::make_rect(1, 1); };
+		make_shape circle = [] { return physics::make_circle(0.5); };
+		make_shape capsule = [] { return physics::make_capsule(1, 0.25); };
+		make_shape rounded_box = [] { return physics::make_rounded_rect(1, 1, 0.1); };
+		make_shape large_polygon = []
+		{
+			std::vector<physics::vec_2d> vertices;
+			for (int i = 0; i < 32; i++)
+				vertices.push_back({ 0.5 * std::cos(2.0 * physics::pi * i / 32), 0.5 * std::sin(2.0 * physics::pi * i / 32) });
+
+			return physics::make_polygon(vertices);
+		};
+
+		const narrow_phase_test tests[] = {
+			{ "Polygon-polygon", box, box },
+			{ "Polygon-circle", box, circle },
+			{ "Circle-circle", circle, circle },
+			{ "Capsule-polygon (GJK)", capsule, box },
+			{ "Rounded box pair (GJK)", rounded_box, rounded_box },
+			{ "32 vertex polygon pair (GJK)", large_polygon, large_polygon }
+		};
+
+		for (const narrow_phase_test& test : tests)
+		{
+			narrow_phase_result result;
+			result.name = test.name;
+
+			// Bodies are only used for their shapes, the world is never stepped
+			physics::world test_world;
+			physics::material material;
+
+			std::vector<physics::shape_view> views_a;
+			std::vector<physics::shape_view> views_b;
+
+			for (int i = 0; i < narrow_phase_pairs; i++)
+			{
+				physics::vec_2d position { i * 3.0, 0.0 };
+
+				physics::body* body_a = test_world.create_body(test.make_a(), material, physics::static_body, position, 0.1 * i);
+				physics::body* body_b = test_world.create_body(test.make_b(), material, physics::static_body, { position.x + 0.8, position.y + 0.3 }, 0.3);
+
+				views_a.push_back(physics::get_shape_view(body_a));
+				views_b.push_back(physics::get_shape_view(body_b));
+			}
+
+			size_t allocations = get_allocation_count();
+			size_t collisions = 0;
+			physics::timer timer;
+
+			for (int pass = 0; pass < narrow_phase_passes; pass++)
+			{
+				for (int i = 0; i < narrow_phase_pairs; i++)
+				{
+					physics::collision_manifold collision;
+					collisions += physics::get_collision(views_a[i], views_b[i], collision);
+				}
+			}
+
+			double seconds = timer.elapsed<std::chrono::nanoseconds>() / 1e9;
+			double tests = static_cast<double>(narrow_phase_pairs) * narrow_phase_passes;
+
+			result.tests_per_second = tests / seconds;
+			result.allocations_per_test = (get_allocation_count() - allocations) / tests;
+
+			// Keep the tests from being optimized away
+			if (collisions == 0)
+				result.name = "No collisions";
+
+			narrow_phase_results.push_back(result);
+		}
+	}
+
+	void benchmark_scene::run_n_body_benchmark()
+	{
+		n_body_results.clear();
+
+		physics::thread_pool thread_pool;
+		thread_pool.set_thread_count(world.get_thread_count());
+
+		physics::n_body_settings settings;
+		settings.enabled = true;
+		settings.gravitational_constant = 1.0;
+		settings.softening = 1.0;
+
+		for (size_t body_count : { 1000, 10000 })
+		{
+			n_body_result result;
+			result.body_count = body_count;
+
+			// The same bodies scattered over a square, in one storage for each mode
+			random::fast_random rng { 0 };
+			physics::body_storage barnes_hut_storage;
+			physics::body_storage exact_storage;
+
+			for (size_t i = 0; i < body_count; i++)
+			{
+				physics::vec_2d position { rng.get_double(-1000.0, 1000.0), rng.get_double(-1000.0, 1000.0) };
+				double inv_mass = 1.0 / rng.get_double(1.0, 100.0);
+
+				for (physics::body_storage* storage : { &barnes_hut_storage, &exact_storage })
+				{
+					size_t index = storage->add();
+					storage->set_position(index, position);
+					storage->inv_mass[index] = inv_mass;
+					storage->motion_mask[index] = 1.0;
+				}
+			}
+
+			physics::n_body_gravity gravity;
+			physics::timer timer;
+
+			settings.mode = physics::n_body_mode::barnes_hut;
+			gravity.apply(barnes_hut_storage, settings, thread_pool);
+			result.barnes_hut_milliseconds = timer.elapsed<std::chrono::microseconds>() / 1000.0;
+
+			timer.reset();
+			settings.mode = physics::n_body_mode::exact;
+			gravity.apply(exact_storage, settings, thread_pool);
+			result.exact_milliseconds = timer.elapsed<std::chrono::microseconds>() / 1000.0;
+
+			double error_sum = 0.0;
+			for (size_t i = 0; i < body_count; i++)
+			{
+				physics::vec_2d exact_force { exact_storage.force_x[i], exact_storage.force_y[i] };
+				physics::vec_2d error { barnes_hut_storage.force_x[i] - exact_force.x, barnes_hut_storage.force_y[i] - exact_force.y };
+
+				error_sum += physics::vec_magnitude(error) / physics::vec_magnitude(exact_force);
+			}
+
+			result.mean_relative_error = error_sum / body_count;
+
+			n_body_results.push_back(result);
+		}
+	}
+
+	void benchmark_scene::update_menu()
+	{
+		if (!ImGui::Begin("Physics Engine Demo"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		ImGui::NewLine();
+
+		if (ImGui::TreeNodeEx("Integrator", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("Bodies integrated per second with each instruction set");
+
+			if (ImGui::Button("Run"))
+			{
+				run_integrator_benchmark();
+			}
+
+			const char* level_names[] = { "Scalar", "SSE2", "AVX2" };
+
+			for (const integrator_result& result : integrator_results)
+			{
+				ImGui::NewLine();
+				ImGui::Text("%zu bodies", result.body_count);
+
+				for (int level = 0; level < 3; level++)
+				{
+					if (result.bodies_per_second[level] > 0.0)
+						ImGui::Text("%s: %.2f million bodies/s", level_names[level], result.bodies_per_second[level] / 1e6);
+					else
+						ImGui::Text("%s: unsupported", level_names[level]);
+				}
+			}
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNodeEx("Narrow phase", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("Collision tests of overlapping pairs");
+
+			if (!counts_engine_allocations)
+				ImGui::Text("Heap allocations made inside the engine DLL are not counted in this configuration");
+
+			if (ImGui::Button("Run##narrow_phase"))
+			{
+				run_narrow_phase_benchmark();
+			}
+
+			for (const narrow_phase_result& result : narrow_phase_results)
+			{
+				ImGui::NewLine();
+				ImGui::Text("%s: %.2f million tests/s", result.name, result.tests_per_second / 1e6);
+				ImGui::Text("Heap allocations per test: %.2f", result.allocations_per_test);
+			}
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNodeEx("World step", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("Resting bodies stepped with sleeping disabled");
+
+			if (!counts_engine_allocations)
+				ImGui::Text("Heap allocations made inside the engine DLL are not counted in this configuration");
+
+			if (ImGui::Button("Run##step"))
+			{
+				run_step_benchmark();
+			}
+
+			for (const step_result& result : step_results)
+			{
+				ImGui::NewLine();
+				ImGui::Text("%s: %zu bodies, %zu contacts", result.name, result.body_count, result.contact_count);
+				ImGui::Text("Step time: %.3f ms", result.milliseconds_per_step);
+				ImGui::Text("Heap allocations per step: %.2f", result.allocations_per_step);
+			}
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNodeEx("N-body gravity", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("Forces between randomly placed bodies");
+
+			if (ImGui::Button("Run##n_body"))
+			{
+				run_n_body_benchmark();
+			}
+
+			for (const n_body_result& result : n_body_results)
+			{
+				ImGui::NewLine();
+				ImGui::Text("%zu bodies", result.body_count);
+				ImGui::Text("Barnes-Hut: %.3f ms", result.barnes_hut_milliseconds);
+				ImGui::Text("Exact: %.3f ms", result.exact_milliseconds);
+				ImGui::Text("Mean relative error: %.3f%%", result.mean_relative_error * 100.0);
+			}
+
+			ImGui::TreePop();
+		}
+
+		ImGui::End();
+	}
+}
\ No newline at end of file
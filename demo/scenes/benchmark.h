@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../scene.h"
+
+namespace demo
+{
+	// Measures the throughput of engine subsystems outside of a running world
+	class benchmark_scene : public scene
+	{
+	private:
+		struct integrator_result
+		{
+			size_t body_count { 0 };
+
+			// Bodies integrated per second for each instruction set (0 if unsupported)
+			double bodies_per_second[3] {};
+		};
+
+		struct step_result
+		{
+			const char* name { "" };
+			size_t body_count { 0 };
+			size_t contact_count { 0 };
+
+			double milliseconds_per_step { 0.0 };
+			double allocations_per_step { 0.0 };
+		};
+
+		struct narrow_phase_result
+		{
+			const char* name { "" };
+
+			double tests_per_second { 0.0 };
+			double allocations_per_test { 0.0 };
+		};
+
+		struct n_body_result
+		{
+			size_t body_count { 0 };
+
+			double barnes_hut_milliseconds { 0.0 };
+			double exact_milliseconds { 0.0 };
+
+			// Mean error of the Barnes-Hut forces relative to the exact forces
+			double mean_relative_error { 0.0 };
+		};
+
+		std::vector<integrator_result> integrator_results {};
+		std::vector<step_result> step_results {};
+		std::vector<narrow_phase_result> narrow_phase_results {};
+		std::vector<n_body_result> n_body_results {};
+
+		// Number of timesteps each integrator run is averaged over
+		const int integrator_steps = 20;
+
+		// Steps taken for the bodies to settle, and steps measured afterwards
+		const int settle_steps = 300;
+		const int measured_steps = 100;
+
+		// Number of overlapping pairs and how many times each is tested
+		const int narrow_phase_pairs = 1000;
+		const int narrow_phase_passes = 200;
+
+		void run_integrator_benchmark();
+
+		// Steps worlds of resting bodies and measures the time and heap allocations of each step
+		void run_step_benchmark();
+
+		// Tests overlapping pairs of shapes directly and measures the time and heap allocations of each test
+		void run_narrow_phase_benchmark();
+
+		// Finds the gravity between randomly placed bodies with Barnes-Hut and exactly, and compares the forces
+		void run_n_body_benchmark();
+
+	public:
+		benchmark_scene(physics::world& world);
+
+		void start();
+		void update_menu() override;
+	};
+}
\ No newline at end of file
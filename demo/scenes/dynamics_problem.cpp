@@ -47,6 +47,26 @@ namespace demo
 		object_ptr box_obj = std::make_unique<demo::polygon_object>(box_body);
 		objects.push_back(std::move(box_obj));
 
+		// Place the same ramp and box in the float world, stepped alongside the double world
+		float_world.set_gravity({ static_cast<float>(world.get_gravity().x), static_cast<float>(world.get_gravity().y) });
+		float_world.set_solver_settings(world.get_solver_settings());
+		float_world.set_sleep_settings(world.get_sleep_settings());
+
+		physics::materialf float_material;
+		float_material.kinetic_friction = static_cast<float>(material.kinetic_friction);
+		float_material.static_friction = 0;
+
+		std::vector<physics::vec_2f> float_ramp_vertices;
+		for (const physics::vec_2d& vertex : ramp_vertices)
+			float_ramp_vertices.push_back({ static_cast<float>(vertex.x), static_cast<float>(vertex.y) });
+
+		physics::basic_shape_ptr<float> float_ramp = physics::make_polygon<float>(float_ramp_vertices);
+		physics::vec_2f float_centroid = float_ramp->get_centroid();
+		float_world.create_body(std::move(float_ramp), float_material, physics::static_body, float_centroid);
+
+		float_start_point = { static_cast<float>(start_point.x), static_cast<float>(start_point.y) };
+		float_box_body = float_world.create_body(physics::make_rect<float>(1, 1), float_material, physics::dynamic_body, float_start_point, static_cast<float>(physics::deg_to_rad(90.0 - ramp_angle)));
+
 		// Calculate the estimated final speed
 		double gravity = std::abs(world.get_gravity().y);
 		calculated_value = std::sqrt(2.0 * gravity * travel_length * (std::sin(angle_rad) - kinetic_friction * std::cos(angle_rad)));
@@ -66,6 +86,19 @@ namespace demo
 				box_body->set_type(physics::static_body);
 			}
 		}
+
+		if (!float_reached_end)
+		{
+			float_world.step(static_cast<float>(dt), 1);
+
+			float distance = physics::get_distance(float_box_body->get_position(), float_start_point);
+
+			if (distance >= travel_length)
+			{
+				float_reached_end = true;
+				float_final_speed = physics::vec_magnitude(float_box_body->get_velocity());
+			}
+		}
 	}
 
 	void dynamics_problem_scene::update_menu()
@@ -94,6 +127,14 @@ namespace demo
 				ImGui::Text("Measured final speed: %.4fm/s", final_speed);
 			}
 
+			if (float_reached_end)
+			{
+				ImGui::Text("Measured final speed (float): %.4fm/s", float_final_speed);
+
+				if (reached_end)
+					ImGui::Text("Float error against double: %.6fm/s", std::abs(float_final_speed - final_speed));
+			}
+
 			ImGui::TreePop();
 		}
 
@@ -19,6 +19,13 @@ namespace demo
 		physics::vec_2d start_point{};
 		physics::body* box_body{ nullptr };
 
+		// The same box and ramp in a float world, to validate float precision against the double world
+		physics::worldf float_world {};
+		physics::bodyf* float_box_body { nullptr };
+		physics::vec_2f float_start_point {};
+		float float_final_speed {};
+		bool float_reached_end = false;
+
 	public:
 		dynamics_problem_scene(physics::world& world);
 
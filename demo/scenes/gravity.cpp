@@ -16,6 +16,12 @@ namespace demo
 	{
 		world.set_gravity(physics::vec_zero);
 
+		// The bodies only attract each other
+		physics::n_body_settings n_body_settings;
+		n_body_settings.enabled = true;
+		n_body_settings.gravitational_constant = G;
+		world.set_n_body_settings(n_body_settings);
+
 		gravity_body sun;
 		sun.mass = 2.5e19;
 		sun.position = { 0, 0 };
@@ -96,31 +102,6 @@ namespace demo
 		trails.resize(gravity_bodies.size());
 	}
 
-	void gravity_scene::update_world(double dt, application& app)
-	{
-		for (size_t i = 0; i < objects.size(); i++)
-		{
-			double mass_a = objects[i]->get_body()->get_mass();
-			physics::vec_2d pos_a = objects[i]->get_body()->get_position();
-
-			for (size_t j = 0; j < objects.size(); j++)
-			{
-				if (i == j)
-					continue;
-
-				double mass_b = objects[j]->get_body()->get_mass();
-				physics::vec_2d pos_b = objects[j]->get_body()->get_position();
-
-				physics::vec_2d normal = vec_normalize(physics::vec_sub(pos_b, pos_a));
-				double gravity_force = (G * mass_a * mass_b) / physics::get_distance_sq(pos_a, pos_b);
-
-				physics::vec_2d force_vector = physics::vec_mul(normal, gravity_force);
-
-				objects[i]->get_body()->apply_force(force_vector);
-			}
-		}
-	}
-
 	void gravity_scene::update_scene(const std::vector<sf::Event>& events, application& app)
 	{
 		for (size_t i = 0; i < objects.size(); i++)
@@ -18,6 +18,7 @@ namespace demo
 
 		std::vector<std::deque<physics::vec_2d>> trails {};
 
+		// Gravitational constant used by the world's n-body gravity
 		const double G = 6.67e-11;
 		const size_t trail_length = 1000;
 
@@ -25,7 +26,6 @@ namespace demo
 		gravity_scene(physics::world& world);
 
 		void start();
-		void update_world(double dt, application& app) override;
 		void update_scene(const std::vector<sf::Event>& events, application& app) override;
 		void draw(application& app, sf::RenderWindow& window) override;
 		//void update_menu() override;
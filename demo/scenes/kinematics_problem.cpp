@@ -28,6 +28,16 @@ namespace demo
 		double angle = physics::deg_to_rad(launch_angle);
 		body->set_velocity({ launch_speed * std::cos(angle), launch_speed * std::sin(angle) });
 
+		// Launch the same ball in the float world, stepped alongside the double world
+		float_world.set_gravity({ static_cast<float>(world.get_gravity().x), static_cast<float>(world.get_gravity().y) });
+		float_world.set_solver_settings(world.get_solver_settings());
+		float_world.set_sleep_settings(world.get_sleep_settings());
+
+		float_world.create_body(physics::make_rect<float>(150, 2), physics::materialf {}, physics::static_body, { 0, -2.001f });
+		float_body = float_world.create_body(physics::make_circle<float>(1), physics::materialf {}, physics::dynamic_body);
+		float_start_height = float_body->get_position().y;
+		float_body->set_velocity({ static_cast<float>(launch_speed * std::cos(angle)), static_cast<float>(launch_speed * std::sin(angle)) });
+
 		// Calculate the estimated range and height
 		double gravity = std::abs(world.get_gravity().y);
 		calculated_value_range = ((launch_speed * launch_speed) * std::sin(2.0 * angle)) / gravity;
@@ -49,6 +59,21 @@ namespace demo
 				range = body->get_position().x;
 			}
 		}
+
+		if (!float_landed)
+		{
+			float_world.step(static_cast<float>(dt), 1);
+
+			float height = float_body->get_position().y;
+			float_max_height = std::max(float_max_height, height);
+
+			if (height <= float_start_height)
+			{
+				float_landed = true;
+
+				float_range = float_body->get_position().x;
+			}
+		}
 	}
 	void kinematics_problem_scene::update_menu()
 	{
@@ -79,6 +104,16 @@ namespace demo
 				ImGui::Text("Measured max height: %.4fm", max_height);
 			}
 
+			if (float_landed)
+			{
+				ImGui::NewLine();
+				ImGui::Text("Measured range (float): %.4fm", float_range);
+				ImGui::Text("Measured max height (float): %.4fm", float_max_height);
+
+				if (landed)
+					ImGui::Text("Float error against double: %.6fm range, %.6fm height", std::abs(float_range - range), std::abs(float_max_height - max_height));
+			}
+
 			ImGui::TreePop();
 		}
 
@@ -20,6 +20,14 @@ namespace demo
 
 		physics::vec_2d start_point{};
 		physics::body* body { nullptr };
+
+		// The same launch in a float world, to validate float precision against the double world
+		physics::worldf float_world {};
+		physics::bodyf* float_body { nullptr };
+		float float_start_height {};
+		float float_max_height {};
+		float float_range {};
+		bool float_landed = false;
 	public:
 
 		kinematics_problem_scene(physics::world& world);
@@ -106,6 +106,25 @@ namespace demo
 							rect_obj->set_outline_color(sf_outline_color);
 							objects.push_back(std::move(rect_obj));
 						}
+						else if (selected_shape_type == create_shape_type::capsule)
+						{
+							double length = create_shape_length;
+							double radius = create_shape_radius;
+
+							if (random_size)
+							{
+								length = rng.get_double(0.5, 1.5);
+								radius = rng.get_double(0.2, 0.5);
+							}
+
+							physics::shape_ptr capsule = physics::make_capsule(length, radius);
+							physics::body* capsule_body = world.create_body(std::move(capsule), create_shape_material, body_type, position);
+							capsule_body->set_rotation(-physics::deg_to_rad(create_shape_rotation));
+							object_ptr capsule_obj = std::make_unique<demo::polygon_object>(capsule_body);
+							capsule_obj->set_color(sf_fill_color);
+							capsule_obj->set_outline_color(sf_outline_color);
+							objects.push_back(std::move(capsule_obj));
+						}
 						else if (selected_shape_type == create_shape_type::polygon)
 						{
 							if (creating_polygon && !create_shape_polygon_closed)
@@ -178,7 +197,7 @@ namespace demo
 
 							if (type == physics::shape_type::polygon)
 							{
-								const std::vector<physics::vec_2d> vertices = obj->get_body()->get_translated_vertices();
+								const physics::vertex_array& vertices = obj->get_body()->get_translated_vertices();
 
 								// Ray casting algorithm
 								// https://en.wikipedia.org/wiki/Point_in_polygon
@@ -213,6 +232,20 @@ namespace demo
 									break;
 								}
 							}
+							else if (type == physics::shape_type::rounded_polygon)
+							{
+								// The mouse is a circle of no radius, so a distance query tells if it's inside the shape
+								physics::shape_view mouse_view {};
+								mouse_view.type = physics::shape_type::circle;
+								mouse_view.origin = mouse_pos;
+
+								if (physics::get_distance(physics::get_shape_view(obj->get_body()), mouse_view).overlap)
+								{
+									selected_object_index = index;
+									object_found = true;
+									break;
+								}
+							}
 
 							index++;
 						}
@@ -306,6 +339,11 @@ namespace demo
 							selected_shape_type = create_shape_type::polygon;
 						}
 
+						if (ImGui::Selectable("Capsule", selected_shape_type == create_shape_type::capsule))
+						{
+							selected_shape_type = create_shape_type::capsule;
+						}
+
 						ImGui::NewLine();
 
 						ImGui::PushItemWidth(120);
@@ -326,6 +364,15 @@ namespace demo
 							create_shape_height = std::max(create_shape_height, 0.0);
 						}
 
+						if (selected_shape_type == create_shape_type::capsule)
+						{
+							ImGui::Checkbox("Random Size", &random_size);
+							ImGui::InputDouble("Length", &create_shape_length, 0.1, 0.5, "%.3f");
+							ImGui::InputDouble("Radius", &create_shape_radius, 0.1, 0.5, "%.3f");
+							create_shape_length = std::max(create_shape_length, 0.0);
+							create_shape_radius = std::max(create_shape_radius, 0.0);
+						}
+
 						ImGui::InputDouble("Rotation", &create_shape_rotation, 1.0, 10.0, "%.f deg");
 
 						if (selected_shape_type == create_shape_type::polygon)
@@ -439,6 +486,10 @@ namespace demo
 					{
 						ImGui::Text("Polygon");
 					}
+					else if (shape_type == physics::shape_type::rounded_polygon)
+					{
+						ImGui::Text("Rounded polygon");
+					}
 
 					std::string mass_text = "Mass: " + std::to_string(objects[selected_object_index]->get_body()->get_mass()) + " kg";
 					ImGui::Text(mass_text.c_str());
@@ -20,7 +20,8 @@ namespace demo
 		{
 			circle,
 			rectangle,
-			polygon
+			polygon,
+			capsule
 		};
 
 		mode selected_mode { mode::view };
@@ -30,6 +31,7 @@ namespace demo
 		double create_shape_radius{ 0.5 };
 		double create_shape_width{ 1.0 };
 		double create_shape_height{ 1.0 };
+		double create_shape_length{ 1.0 };
 		double create_shape_rotation { 0.0 };
 		physics::material create_shape_material {};
 		physics::body_type body_type = physics::dynamic_body;
@@ -3,4 +3,5 @@
 #include "playground.h"
 #include "gravity.h"
 #include "kinematics_problem.h"
-#include "dynamics_problem.h"
\ No newline at end of file
+#include "dynamics_problem.h"
+#include "benchmark.h"
\ No newline at end of file
@@ -1,10 +1,43 @@
 #include "aabb.h"
+#include <algorithm>
 
-physics::aabb::aabb(physics::vec_2d min, physics::vec_2d max)
+template <typename real>
+physics::basic_aabb<real>::basic_aabb(physics::vec_2<real> min, physics::vec_2<real> max)
 	: min(min), max(max)
 {}
 
-bool physics::aabb_intersection(physics::aabb a, physics::aabb b)
+template <typename real>
+bool physics::aabb_intersection(physics::basic_aabb<real> a, physics::basic_aabb<real> b)
 {
 	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y;
-}
\ No newline at end of file
+}
+
+template <typename real>
+bool physics::aabb_contains(physics::basic_aabb<real> a, physics::basic_aabb<real> b)
+{
+	return a.min.x <= b.min.x && a.min.y <= b.min.y && a.max.x >= b.max.x && a.max.y >= b.max.y;
+}
+
+template <typename real>
+physics::basic_aabb<real> physics::aabb_union(physics::basic_aabb<real> a, physics::basic_aabb<real> b)
+{
+	return physics::basic_aabb<real>({ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y) }, { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y) });
+}
+
+template <typename real>
+real physics::aabb_perimeter(physics::basic_aabb<real> aabb)
+{
+	return real(2) * ((aabb.max.x - aabb.min.x) + (aabb.max.y - aabb.min.y));
+}
+
+template struct physics::basic_aabb<float>;
+template struct physics::basic_aabb<double>;
+
+template bool physics::aabb_intersection(physics::aabbf, physics::aabbf);
+template bool physics::aabb_intersection(physics::aabb, physics::aabb);
+template bool physics::aabb_contains(physics::aabbf, physics::aabbf);
+template bool physics::aabb_contains(physics::aabb, physics::aabb);
+template physics::aabbf physics::aabb_union(physics::aabbf, physics::aabbf);
+template physics::aabb physics::aabb_union(physics::aabb, physics::aabb);
+template float physics::aabb_perimeter(physics::aabbf);
+template double physics::aabb_perimeter(physics::aabb);
\ No newline at end of file
@@ -5,15 +5,28 @@
 namespace physics
 {
 	// Axis-Aligned Bounding Box
-	struct aabb
+	template <typename real>
+	struct basic_aabb
 	{
-		physics::vec_2d min {};
-		physics::vec_2d max {};
+		physics::vec_2<real> min {};
+		physics::vec_2<real> max {};
 
-		aabb() = default;
-		aabb(physics::vec_2d min, physics::vec_2d max);
+		basic_aabb() = default;
+		basic_aabb(physics::vec_2<real> min, physics::vec_2<real> max);
 	};
 
+	using aabb = basic_aabb<double>;
+	using aabbf = basic_aabb<float>;
+
 	// Returns true if two axis-aligned bounding boxes intersect
-	bool aabb_intersection(physics::aabb a, physics::aabb b);
+	template <typename real> bool aabb_intersection(physics::basic_aabb<real> a, physics::basic_aabb<real> b);
+
+	// Returns true if AABB a fully contains AABB b
+	template <typename real> bool aabb_contains(physics::basic_aabb<real> a, physics::basic_aabb<real> b);
+
+	// Returns the smallest AABB containing both AABBs
+	template <typename real> physics::basic_aabb<real> aabb_union(physics::basic_aabb<real> a, physics::basic_aabb<real> b);
+
+	// Returns the perimeter of an AABB
+	template <typename real> real aabb_perimeter(physics::basic_aabb<real> aabb);
 }
\ No newline at end of file
@@ -1,163 +1,298 @@
 ﻿#include "body.h"
+#include "world.h"
 #include <cassert>
+#include <limits>
 
-void physics::body::calculate_mass()
+template <typename real>
+physics::basic_body_storage<real>& physics::basic_body<real>::get_storage() const
 {
+	return world->storage;
+}
+
+template <typename real>
+void physics::basic_body<real>::calculate_mass()
+{
+	physics::basic_body_storage<real>& storage = get_storage();
+
 	if (type == body_type::static_body)
 	{
-		mass = 0.0;
-		moment_of_inertia = 0.0;
-		inv_mass = 0.0;
-		inv_moment_of_inertia = 0.0;
+		mass = 0;
+		moment_of_inertia = 0;
+		storage.inv_mass[index] = 0;
+		storage.inv_moment_of_inertia[index] = 0;
 	}
 	else
 	{
 		mass = shape->get_area() * material.density;
 		moment_of_inertia = shape->get_area_of_inertia() * material.density;
-		inv_mass = 1.0 / mass;
-		inv_moment_of_inertia = 1.0 / moment_of_inertia;
+		storage.inv_mass[index] = mass > 0 ? 1 / mass : 0;
+		storage.inv_moment_of_inertia[index] = moment_of_inertia > 0 ? 1 / moment_of_inertia : 0;
 	}
+
+	// Static, massless and sleeping bodies are not integrated
+	storage.update_motion_mask(index);
 }
 
-physics::body::body(shape_ptr shape, physics::material material, physics::body_type type, physics::vec_2d position, double rotation)
-	: shape(std::move(shape)), material(material), type(type), position(position), rotation(rotation)
+template <typename real>
+void physics::basic_body<real>::on_transform_changed()
 {
+	get_storage().shape_dirty[index] = 1;
+
+	if (type != physics::static_body)
+	{
+		wake();
+		return;
+	}
+
+	physics::basic_aabb<real> old_aabb = get_storage().aabb[index];
+	update_shape();
+
+	world->on_body_changed(old_aabb, get_storage().aabb[index], false);
+}
+
+template <typename real>
+physics::basic_body<real>::basic_body(physics::basic_world<real>* world, size_t index, physics::basic_shape_ptr<real> shape, physics::basic_material<real> material, physics::body_type type, physics::vec_2<real> position, real rotation)
+	: world(world), index(index), shape(std::move(shape)), material(material), type(type)
+{
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.set_position(index, position);
+	storage.rotation[index] = rotation;
+
 	calculate_mass();
 	update_shape();
 }
 
-physics::vec_2d physics::body::get_position() const
+template <typename real>
+physics::vec_2<real> physics::basic_body<real>::get_position() const
+{
+	return get_storage().get_position(index);
+}
+
+template <typename real>
+real physics::basic_body<real>::get_rotation() const
 {
-	return position;
+	return get_storage().rotation[index];
 }
 
-double physics::body::get_rotation() const
+template <typename real>
+void physics::basic_body<real>::move(real dx, real dy)
 {
-	return rotation;
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.position_x[index] += dx;
+	storage.position_y[index] += dy;
+
+	on_transform_changed();
 }
 
-void physics::body::move(double dx, double dy)
+template <typename real>
+void physics::basic_body<real>::move(physics::vec_2<real> displacement)
 {
-	position.x += dx;
-	position.y += dy;
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.position_x[index] += displacement.x;
+	storage.position_y[index] += displacement.y;
+
+	on_transform_changed();
 }
 
-void physics::body::move(physics::vec_2d displacement)
+template <typename real>
+void physics::basic_body<real>::rotate(real theta)
 {
-	position = vec_add(position, displacement);
+	get_storage().rotation[index] += theta;
+
+	on_transform_changed();
 }
 
-void physics::body::rotate(double theta)
+template <typename real>
+physics::vec_2<real> physics::basic_body<real>::get_velocity() const
 {
-	rotation += theta;
+	return get_storage().get_velocity(index);
 }
 
-physics::vec_2d physics::body::get_velocity() const
+template <typename real>
+real physics::basic_body<real>::get_angular_velocity() const
 {
-	return velocity;
+	return get_storage().angular_velocity[index];
 }
 
-void physics::body::set_transforn(physics::vec_2d position, double rotation)
+template <typename real>
+void physics::basic_body<real>::set_transforn(physics::vec_2<real> position, real rotation)
 {
-	this->position = position;
-	this->rotation = rotation;
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.set_position(index, position);
+	storage.rotation[index] = rotation;
+
+	on_transform_changed();
 }
 
-const size_t physics::body::get_id() const
+template <typename real>
+const size_t physics::basic_body<real>::get_id() const
 {
 	return id;
 }
 
-void physics::body::set_position(physics::vec_2d position)
+template <typename real>
+void physics::basic_body<real>::set_position(physics::vec_2<real> position)
+{
+	get_storage().set_position(index, position);
+
+	on_transform_changed();
+}
+
+template <typename real>
+void physics::basic_body<real>::set_rotation(real rotation)
 {
-	this->position = position;
+	get_storage().rotation[index] = rotation;
+
+	on_transform_changed();
 }
 
-void physics::body::set_rotation(double rotation)
+template <typename real>
+void physics::basic_body<real>::apply_impulse(physics::vec_2<real> impulse)
 {
-	this->rotation = rotation;
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.velocity_x[index] += impulse.x * storage.inv_mass[index];
+	storage.velocity_y[index] += impulse.y * storage.inv_mass[index];
+
+	wake();
 }
 
-void physics::body::apply_impulse(physics::vec_2d impulse)
+template <typename real>
+void physics::basic_body<real>::apply_force(physics::vec_2<real> applied_force)
 {
-	velocity = vec_add(velocity, vec_mul(impulse, inv_mass));
+	physics::basic_body_storage<real>& storage = get_storage();
+	storage.force_x[index] += applied_force.x;
+	storage.force_y[index] += applied_force.y;
+
+	wake();
 }
 
-void physics::body::apply_force(physics::vec_2d applied_force)
+template <typename real>
+void physics::basic_body<real>::set_velocity(physics::vec_2<real> new_velocity)
 {
-	force = vec_add(force, applied_force);
+	get_storage().set_velocity(index, new_velocity);
+
+	wake();
 }
 
-void physics::body::set_velocity(physics::vec_2d new_velocity)
+template <typename real>
+bool physics::basic_body<real>::is_sleeping() const
 {
-	velocity = new_velocity;
+	return get_storage().is_sleeping(index);
 }
 
-double physics::body::get_mass() const
+template <typename real>
+void physics::basic_body<real>::wake()
+{
+	world->wake_body(index);
+}
+
+template <typename real>
+real physics::basic_body<real>::get_mass() const
 {
 	return mass;
 }
 
-double physics::body::get_inverse_mass() const
+template <typename real>
+real physics::basic_body<real>::get_inverse_mass() const
 {
-	return inv_mass;
+	return get_storage().inv_mass[index];
 }
 
-double physics::body::get_moment_of_inertia() const
+template <typename real>
+real physics::basic_body<real>::get_moment_of_inertia() const
 {
 	return moment_of_inertia;
 }
 
-double physics::body::get_inv_moment_of_inertia() const
+template <typename real>
+real physics::basic_body<real>::get_inv_moment_of_inertia() const
 {
-	return inv_moment_of_inertia;
+	return get_storage().inv_moment_of_inertia[index];
 }
 
-const physics::shape* physics::body::get_shape()
+template <typename real>
+const physics::basic_shape<real>* physics::basic_body<real>::get_shape()
 {
 	return shape.get();
 }
 
-physics::material physics::body::get_material()
+template <typename real>
+physics::basic_material<real> physics::basic_body<real>::get_material() const
 {
 	return material;
 }
 
-void physics::body::set_material(physics::material material)
+template <typename real>
+void physics::basic_body<real>::set_material(physics::basic_material<real> material)
 {
 	this->material = material;
 	calculate_mass();
 }
 
-physics::body_type physics::body::get_type()
+template <typename real>
+physics::body_type physics::basic_body<real>::get_type() const
 {
 	return type;
 }
 
-void physics::body::set_type(body_type type)
+template <typename real>
+void physics::basic_body<real>::set_type(body_type type)
 {
+	if (this->type == type)
+		return;
+
+	wake();
+
+	physics::basic_aabb<real> old_aabb = get_storage().aabb[index];
+
 	this->type = type;
 	calculate_mass();
+	update_shape();
+
+	world->on_body_changed(old_aabb, get_storage().aabb[index], true);
 }
 
-const std::vector<physics::vec_2d>& physics::body::get_translated_vertices() const
+template <typename real>
+const physics::basic_vertex_array<real>& physics::basic_body<real>::get_translated_vertices() const
 {
 	return translated_vertices;
 }
 
-void physics::body::update_shape()
+template <typename real>
+const physics::basic_vertex_array<real>& physics::basic_body<real>::get_translated_normals() const
 {
+	return translated_normals;
+}
+
+template <typename real>
+void physics::basic_body<real>::update_shape()
+{
+	physics::basic_body_storage<real>& storage = get_storage();
+	physics::basic_aabb<real>& aabb = storage.aabb[index];
+	physics::vec_2<real> position = storage.get_position(index);
+	real rotation = storage.rotation[index];
+
+	if (!shape_updated || rotation != shape_rotation)
+		rotation_matrix = world->deterministic ? physics::make_deterministic_rotation_matrix(rotation) : physics::make_rotation_matrix(rotation);
+
+	shape_rotation = rotation;
+	shape_updated = true;
+	storage.shape_dirty[index] = 0;
+
 	physics::shape_type shape_type = shape->get_type();
 
-	if (shape_type == physics::shape_type::polygon)
+	if (shape_type == physics::shape_type::polygon || shape_type == physics::shape_type::rounded_polygon)
 	{
-		aabb.min = { DBL_MAX, DBL_MAX };
-		aabb.max = { -DBL_MAX, -DBL_MAX };
+		aabb.min = { std::numeric_limits<real>::max(), std::numeric_limits<real>::max() };
+		aabb.max = { -std::numeric_limits<real>::max(), -std::numeric_limits<real>::max() };
 
-		translated_vertices = static_cast<const physics::polygon*>(shape.get())->get_vertices();
-		translate_vertices(translated_vertices, position, rotation, shape.get()->get_centroid());
+		translated_vertices.assign(static_cast<const physics::basic_polygon<real>*>(shape.get())->get_vertices());
+		translate_vertices(translated_vertices, position, rotation_matrix, shape.get()->get_centroid());
 
-		for (const physics::vec_2d& vertex : translated_vertices)
+		translated_normals.assign(static_cast<const physics::basic_polygon<real>*>(shape.get())->get_normals());
+		rotate_normals(translated_normals, rotation_matrix);
+
+		for (const physics::vec_2<real>& vertex : translated_vertices)
 		{
 			aabb.min.x = std::min(aabb.min.x, vertex.x);
 			aabb.min.y = std::min(aabb.min.y, vertex.y);
@@ -165,10 +300,19 @@ void physics::body::update_shape()
 			aabb.max.x = std::max(aabb.max.x, vertex.x);
 			aabb.max.y = std::max(aabb.max.y, vertex.y);
 		}
+
+		// Rounded polygons extend a radius past their vertices
+		if (shape_type == physics::shape_type::rounded_polygon)
+		{
+			real radius = static_cast<const physics::basic_rounded_polygon<real>*>(shape.get())->get_radius();
+
+			aabb.min = { aabb.min.x - radius, aabb.min.y - radius };
+			aabb.max = { aabb.max.x + radius, aabb.max.y + radius };
+		}
 	}
 	else if (shape_type == physics::shape_type::circle)
 	{
-		double radius = static_cast<const physics::circle*>(shape.get())->get_radius();
+		real radius = static_cast<const physics::basic_circle<real>*>(shape.get())->get_radius();
 
 		aabb.min.x = position.x - radius;
 		aabb.min.y = position.y - radius;
@@ -178,12 +322,17 @@ void physics::body::update_shape()
 	}
 }
 
-physics::aabb physics::body::get_aabb()
+template <typename real>
+physics::basic_aabb<real> physics::basic_body<real>::get_aabb() const
 {
-	return aabb;
+	return get_storage().aabb[index];
 }
 
-bool physics::body::operator==(const body& other)
+template <typename real>
+bool physics::basic_body<real>::operator==(const basic_body& other)
 {
 	return id == other.id;
 }
+
+template class physics::basic_body<float>;
+template class physics::basic_body<double>;
@@ -16,100 +16,128 @@ namespace physics
 	const body_type static_body = body_type::static_body;
 	const body_type dynamic_body = body_type::dynamic_body;
 
-	class world;
+	template <typename real>
+	class basic_world;
 
-	class body
+	template <typename real>
+	struct basic_body_storage;
+
+	template <typename real>
+	class basic_island_set;
+
+	template <typename real>
+	class basic_force_generator_set;
+
+	template <typename real>
+	class basic_body
 	{
-		friend class world;
+		friend class physics::basic_world<real>;
+		friend struct physics::basic_body_storage<real>;
+		friend class physics::basic_island_set<real>;
+		friend class physics::basic_force_generator_set<real>;
 
 	private:
 		// Private constructor (bodies are created by the world class)
-		body(shape_ptr shape, physics::material material, physics::body_type type, physics::vec_2d position, double rotation);
+		basic_body(physics::basic_world<real>* world, size_t index, physics::basic_shape_ptr<real> shape, physics::basic_material<real> material, physics::body_type type, physics::vec_2<real> position, real rotation);
 
 		size_t id { 0 };
 
-		// Body position in world space
-		physics::vec_2d position {};
-
-		// Body velocity
-		physics::vec_2d velocity {};
-
-		// Body rotation
-		double rotation { 0.0 };
-
-		// Angular velocity in radians
-		double angular_velocity { 0.0 };
+		// World the body belongs to
+		physics::basic_world<real>* world { nullptr };
 
-		// Force acting on the body over the current timestep 
-		physics::vec_2d force {};
+		// Index of the body's slot in the world's body storage
+		// Position, velocity, rotation, force, inverse mass and AABB are stored there
+		size_t index { 0 };
 
-		shape_ptr shape;
-		physics::material material {};
-		double mass { 0.0 };
-		double inv_mass { 0.0 };
-		double moment_of_inertia { 0.0 };
-		double inv_moment_of_inertia { 0.0 };
+		physics::basic_shape_ptr<real> shape;
+		physics::basic_material<real> material {};
+		real mass { 0 };
+		real moment_of_inertia { 0 };
 
 		body_type type { physics::static_body };
 
-		// Translated world-space vertices for polygon shapes
-		std::vector<physics::vec_2d> translated_vertices {};
+		// Translated world-space vertices and edge normals for polygon shapes
+		physics::basic_vertex_array<real> translated_vertices {};
+		physics::basic_vertex_array<real> translated_normals {};
 
-		// Axis-Aligned Bounding Box to improve collision detection performance
-		physics::aabb aabb {};
+		// Rotation the shape was last updated with
+		// Sine and cosine are only evaluated again when the rotation changes
+		real shape_rotation { 0 };
+		physics::basic_rotation_matrix<real> rotation_matrix {};
+		bool shape_updated { false };
+
+		physics::basic_body_storage<real>& get_storage() const;
 
 		void calculate_mass();
 
+		// Static bodies are not updated every step, so their shape is updated as soon as they move
+		// Dynamic bodies are woken when they are moved
+		void on_transform_changed();
+
 	public:
-		physics::vec_2d get_position() const;
-		double get_rotation() const;
+		physics::vec_2<real> get_position() const;
+		real get_rotation() const;
 
-		physics::vec_2d get_velocity() const;
+		physics::vec_2<real> get_velocity() const;
+		real get_angular_velocity() const;
 
 		const size_t get_id() const;
 		
-		void move(double dx, double dy);
-		void move(physics::vec_2d displacement);
-		void rotate(double theta);
+		void move(real dx, real dy);
+		void move(physics::vec_2<real> displacement);
+		void rotate(real theta);
 
-		void set_transforn(physics::vec_2d position, double rotation);
-		void set_position(physics::vec_2d position);
-		void set_rotation(double rotation);
+		void set_transforn(physics::vec_2<real> position, real rotation);
+		void set_position(physics::vec_2<real> position);
+		void set_rotation(real rotation);
 
 		// Applies an impulse to the object in units of Ns
-		void apply_impulse(physics::vec_2d impulse);
+		void apply_impulse(physics::vec_2<real> impulse);
 
 		// Applies an impulse to the object at a point in units of Ns
-		// void apply_impulse(physics::vec_2d point, physics::vec_2d impulse);
+		// void apply_impulse(physics::vec_2<real> point, physics::vec_2<real> impulse);
 
 		// Applies a force to the object in units of N
 		// This force will only be applied over the next timestep
-		void apply_force(physics::vec_2d applied_force);
+		void apply_force(physics::vec_2<real> applied_force);
 
 		// Set the object's velocity
-		void set_velocity(physics::vec_2d new_velocity);
+		void set_velocity(physics::vec_2<real> new_velocity);
+
+		// Sleeping bodies are not moved or tested for collision until something wakes them
+		// Applying a force or impulse, setting the velocity or moving a body wakes it
+		bool is_sleeping() const;
 
-		double get_mass() const;
-		double get_inverse_mass() const;
-		double get_moment_of_inertia() const;
-		double get_inv_moment_of_inertia() const;
+		// Wakes the body and every body it fell asleep with
+		void wake();
+
+		real get_mass() const;
+		real get_inverse_mass() const;
+		real get_moment_of_inertia() const;
+		real get_inv_moment_of_inertia() const;
 		
-		const physics::shape* get_shape();
-		//void set_shape(shape_ptr shape);
+		const physics::basic_shape<real>* get_shape();
+		//void set_shape(physics::basic_shape_ptr<real> shape);
 
-		physics::material get_material();
-		void set_material(physics::material material);
+		physics::basic_material<real> get_material() const;
+		void set_material(physics::basic_material<real> material);
 
-		physics::body_type get_type();
+		physics::body_type get_type() const;
 		void set_type(body_type type);
 
 		// Get world-space translated vertices for polygons
-		const std::vector<physics::vec_2d>& get_translated_vertices() const;
+		const physics::basic_vertex_array<real>& get_translated_vertices() const;
+
+		// Get world-space unit edge normals for polygons, normal i belongs to the edge from vertex i to vertex i + 1
+		const physics::basic_vertex_array<real>& get_translated_normals() const;
 
 		// Update the internal shape of the body
 		void update_shape();
-		physics::aabb get_aabb();
+		physics::basic_aabb<real> get_aabb() const;
 
-		bool operator == (const body& other);
+		bool operator == (const basic_body& other);
 	};
+
+	using body = basic_body<double>;
+	using bodyf = basic_body<float>;
 }
\ No newline at end of file
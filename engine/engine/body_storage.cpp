@@ -0,0 +1,137 @@
+#include "body_storage.h"
+#include "body.h"
+
+namespace physics
+{
+	template <typename real>
+	size_t basic_body_storage<real>::add()
+	{
+		position_x.push_back(0);
+		position_y.push_back(0);
+		velocity_x.push_back(0);
+		velocity_y.push_back(0);
+		rotation.push_back(0);
+		angular_velocity.push_back(0);
+		force_x.push_back(0);
+		force_y.push_back(0);
+		inv_mass.push_back(0);
+		inv_moment_of_inertia.push_back(0);
+		motion_mask.push_back(0);
+		sleep_time.push_back(0);
+		rest_position_x.push_back(0);
+		rest_position_y.push_back(0);
+		rest_rotation.push_back(0);
+		sleep_group.push_back(0);
+		shape_dirty.push_back(1);
+		aabb.push_back({});
+		bodies.push_back(nullptr);
+
+		return bodies.size() - 1;
+	}
+
+	// Moves the last element of an array into an index and shrinks the array
+	template<typename type>
+	void swap_remove(std::vector<type>& array, size_t index)
+	{
+		array[index] = array.back();
+		array.pop_back();
+	}
+
+	template <typename real>
+	void basic_body_storage<real>::remove(size_t index)
+	{
+		swap_remove(position_x, index);
+		swap_remove(position_y, index);
+		swap_remove(velocity_x, index);
+		swap_remove(velocity_y, index);
+		swap_remove(rotation, index);
+		swap_remove(angular_velocity, index);
+		swap_remove(force_x, index);
+		swap_remove(force_y, index);
+		swap_remove(inv_mass, index);
+		swap_remove(inv_moment_of_inertia, index);
+		swap_remove(motion_mask, index);
+		swap_remove(sleep_time, index);
+		swap_remove(rest_position_x, index);
+		swap_remove(rest_position_y, index);
+		swap_remove(rest_rotation, index);
+		swap_remove(sleep_group, index);
+		swap_remove(shape_dirty, index);
+		swap_remove(aabb, index);
+		swap_remove(bodies, index);
+
+		if (index < bodies.size())
+			bodies[index]->index = index;
+	}
+
+	template <typename real>
+	void basic_body_storage<real>::clear()
+	{
+		position_x.clear();
+		position_y.clear();
+		velocity_x.clear();
+		velocity_y.clear();
+		rotation.clear();
+		angular_velocity.clear();
+		force_x.clear();
+		force_y.clear();
+		inv_mass.clear();
+		inv_moment_of_inertia.clear();
+		motion_mask.clear();
+		sleep_time.clear();
+		rest_position_x.clear();
+		rest_position_y.clear();
+		rest_rotation.clear();
+		sleep_group.clear();
+		shape_dirty.clear();
+		aabb.clear();
+		bodies.clear();
+	}
+
+	template <typename real>
+	size_t basic_body_storage<real>::size() const
+	{
+		return bodies.size();
+	}
+
+	template <typename real>
+	bool basic_body_storage<real>::is_sleeping(size_t index) const
+	{
+		return sleep_group[index] != 0;
+	}
+
+	template <typename real>
+	void basic_body_storage<real>::update_motion_mask(size_t index)
+	{
+		motion_mask[index] = inv_mass[index] > 0 && !is_sleeping(index) ? real(1) : real(0);
+	}
+
+	template <typename real>
+	physics::vec_2<real> basic_body_storage<real>::get_position(size_t index) const
+	{
+		return { position_x[index], position_y[index] };
+	}
+
+	template <typename real>
+	void basic_body_storage<real>::set_position(size_t index, physics::vec_2<real> position)
+	{
+		position_x[index] = position.x;
+		position_y[index] = position.y;
+	}
+
+	template <typename real>
+	physics::vec_2<real> basic_body_storage<real>::get_velocity(size_t index) const
+	{
+		return { velocity_x[index], velocity_y[index] };
+	}
+
+	template <typename real>
+	void basic_body_storage<real>::set_velocity(size_t index, physics::vec_2<real> velocity)
+	{
+		velocity_x[index] = velocity.x;
+		velocity_y[index] = velocity.y;
+	}
+
+	template struct basic_body_storage<float>;
+	template struct basic_body_storage<double>;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "math.h"
+#include "aabb.h"
+
+namespace physics
+{
+	template <typename real>
+	class basic_body;
+
+	// Structure-of-arrays storage for the body data used every step
+	// Each body owns one slot, and the world's integration loop streams over the arrays
+	template <typename real>
+	struct basic_body_storage
+	{
+		// Body position in world space
+		std::vector<real> position_x {};
+		std::vector<real> position_y {};
+
+		// Body velocity
+		std::vector<real> velocity_x {};
+		std::vector<real> velocity_y {};
+
+		// Body rotation in radians
+		std::vector<real> rotation {};
+
+		// Angular velocity in radians
+		std::vector<real> angular_velocity {};
+
+		// Force acting on the body over the current timestep
+		std::vector<real> force_x {};
+		std::vector<real> force_y {};
+
+		std::vector<real> inv_mass {};
+		std::vector<real> inv_moment_of_inertia {};
+
+		// 1.0 for bodies that are integrated (awake dynamic bodies with mass), 0.0 otherwise
+		// Used instead of a branch so the integration loop can be vectorized
+		std::vector<real> motion_mask {};
+
+		// Time the body has stayed close to where it started resting
+		std::vector<real> sleep_time {};
+
+		// Position and rotation when the body started resting
+		std::vector<real> rest_position_x {};
+		std::vector<real> rest_position_y {};
+		std::vector<real> rest_rotation {};
+
+		// Group of bodies the body fell asleep with, or 0 if the body is awake
+		std::vector<size_t> sleep_group {};
+
+		// 1 if the body moved since its AABB and world space vertices were last updated
+		// Set by integration and the body's transform setters
+		std::vector<uint8_t> shape_dirty {};
+
+		// Axis-Aligned Bounding Box to improve collision detection performance
+		std::vector<physics::basic_aabb<real>> aabb {};
+
+		// Body that owns each slot
+		std::vector<physics::basic_body<real>*> bodies {};
+
+		// Adds a slot and returns its index
+		size_t add();
+
+		// Removes a slot by moving the last slot into it
+		// Updates the index of the body that owned the last slot
+		void remove(size_t index);
+
+		void clear();
+		size_t size() const;
+
+		bool is_sleeping(size_t index) const;
+
+		// Recalculates the motion mask from the inverse mass and sleep state
+		void update_motion_mask(size_t index);
+
+		physics::vec_2<real> get_position(size_t index) const;
+		void set_position(size_t index, physics::vec_2<real> position);
+
+		physics::vec_2<real> get_velocity(size_t index) const;
+		void set_velocity(size_t index, physics::vec_2<real> velocity);
+	};
+
+	using body_storage = basic_body_storage<double>;
+}
\ No newline at end of file
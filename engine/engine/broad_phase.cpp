@@ -0,0 +1,65 @@
+#include "broad_phase.h"
+#include <algorithm>
+
+namespace physics
+{
+	template <typename real>
+	physics::basic_body_pair<real> make_body_pair(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b)
+	{
+		if (body_a->get_id() < body_b->get_id())
+			return { body_a, body_b };
+
+		return { body_b, body_a };
+	}
+
+	template <typename real>
+	void basic_brute_force_broad_phase<real>::insert(physics::basic_body<real>* body)
+	{
+		bodies.push_back(body);
+	}
+
+	template <typename real>
+	void basic_brute_force_broad_phase<real>::remove(physics::basic_body<real>* body)
+	{
+		auto it = std::find(bodies.begin(), bodies.end(), body);
+		if (it != bodies.end())
+			bodies.erase(it);
+	}
+
+	template <typename real>
+	void basic_brute_force_broad_phase<real>::clear()
+	{
+		bodies.clear();
+	}
+
+	template <typename real>
+	void basic_brute_force_broad_phase<real>::update()
+	{}
+
+	template <typename real>
+	void basic_brute_force_broad_phase<real>::find_pairs(std::vector<physics::basic_body_pair<real>>& pairs)
+	{
+		if (bodies.empty())
+			return;
+
+		for (size_t i = 0; i < bodies.size() - 1; i++)
+		{
+			for (size_t j = i + 1; j < bodies.size(); j++)
+			{
+				if (bodies[i]->get_type() == physics::static_body && bodies[j]->get_type() == physics::static_body)
+					continue;
+
+				// If AABBs do not intersect, there is no chance of collision
+				if (!physics::aabb_intersection(bodies[i]->get_aabb(), bodies[j]->get_aabb()))
+					continue;
+
+				pairs.push_back(make_body_pair(bodies[i], bodies[j]));
+			}
+		}
+	}
+
+	template physics::basic_body_pair<float> make_body_pair<float>(physics::basic_body<float>*, physics::basic_body<float>*);
+	template physics::basic_body_pair<double> make_body_pair<double>(physics::basic_body<double>*, physics::basic_body<double>*);
+	template class basic_brute_force_broad_phase<float>;
+	template class basic_brute_force_broad_phase<double>;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "body.h"
+
+namespace physics
+{
+	// Pair of bodies that may be colliding (AABBs overlap)
+	// body_a always has the lower body id
+	template <typename real>
+	struct basic_body_pair
+	{
+		physics::basic_body<real>* body_a { nullptr };
+		physics::basic_body<real>* body_b { nullptr };
+	};
+
+	using body_pair = basic_body_pair<double>;
+
+	enum class broad_phase_type
+	{
+		brute_force,
+		uniform_grid,
+		dynamic_tree,
+		sweep_and_prune
+	};
+
+	// Base broad-phase class
+	// Finds pairs of bodies with overlapping AABBs so the narrow phase only tests bodies that can collide
+	template <typename real>
+	class basic_broad_phase
+	{
+	public:
+		virtual ~basic_broad_phase() = default;
+
+		// Add a body to the broad phase
+		virtual void insert(physics::basic_body<real>* body) = 0;
+
+		// Remove a body from the broad phase
+		virtual void remove(physics::basic_body<real>* body) = 0;
+
+		// Remove all bodies from the broad phase
+		virtual void clear() = 0;
+
+		// Update the broad phase from the current body AABBs
+		// Body shapes must be updated before this is called
+		virtual void update() = 0;
+
+		// Find all pairs of bodies with overlapping AABBs (static-static pairs are never reported)
+		virtual void find_pairs(std::vector<physics::basic_body_pair<real>>& pairs) = 0;
+	};
+
+	// Makes a body pair with the lower body id first
+	template <typename real>
+	physics::basic_body_pair<real> make_body_pair(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b);
+
+	// Tests every pair of bodies (O(n^2))
+	template <typename real>
+	class basic_brute_force_broad_phase : public basic_broad_phase<real>
+	{
+	private:
+		std::vector<physics::basic_body<real>*> bodies {};
+
+	public:
+		void insert(physics::basic_body<real>* body) override;
+		void remove(physics::basic_body<real>* body) override;
+		void clear() override;
+		void update() override;
+		void find_pairs(std::vector<physics::basic_body_pair<real>>& pairs) override;
+	};
+
+	using broad_phase = basic_broad_phase<double>;
+	using brute_force_broad_phase = basic_brute_force_broad_phase<double>;
+}
\ No newline at end of file
@@ -1,33 +1,56 @@
 #include "collision.h"
-#include <vector>
+#include "gjk.h"
 
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 namespace physics
 {
-	physics::vec_2d calculate_axis(physics::vec_2d current_point, physics::vec_2d next_point)
+	template <typename real>
+	void basic_collision_manifold<real>::add_point(physics::vec_2<real> point, real point_depth, uint32_t feature_id)
 	{
-		physics::vec_2d edge = vec_sub(next_point, current_point);
-		physics::vec_2d normal {-edge.y, edge.x};
-		double magnitude = vec_magnitude(edge);
-		// axis does not need to be normalized right now, can be done later to save sqrt calls
-		return physics::vec_2d {normal.x / magnitude, normal.y / magnitude};
+		if (point_count == max_points)
+			return;
+
+		contact_points[point_count] = point;
+		depths[point_count] = point_depth;
+		feature_ids[point_count] = feature_id;
+		point_count++;
+	}
+
+	uint32_t make_feature_id(bool flipped, size_t vertex_index, size_t edge_index)
+	{
+		return (flipped ? 1u << 31 : 0u) | (static_cast<uint32_t>(vertex_index & 0x7fff) << 16) | static_cast<uint32_t>(edge_index & 0xffff);
 	}
 
+	// SAT projects every vertex onto every edge normal, which costs O(n * m) but beats GJK for small polygons
+	// Larger polygons are tested with GJK
+	const size_t sat_max_vertices = 8;
+
+	// How much further an edge of b must separate the polygons than an edge of a to become the reference edge
+	template <typename real> constexpr real reference_edge_tolerance = real(0.001);
+
+	// Separations come from world space vertices, so their rounding error grows with the distance from the origin
+	// In float this is added to the tolerance per unit of distance, so far away polygons don't flip reference edges from rounding
+	template <typename real> constexpr real reference_edge_relative_tolerance = real(0);
+	template <> constexpr float reference_edge_relative_tolerance<float> = 64 * std::numeric_limits<float>::epsilon();
+
+	template <typename real>
 	struct projection
 	{
-		double min{ DBL_MAX };
-		double max{ -DBL_MAX };
+		real min{ std::numeric_limits<real>::max() };
+		real max{ -std::numeric_limits<real>::max() };
 	}; 
 
-	physics::projection project_polygon(const std::vector<physics::vec_2d>& vertices, physics::vec_2d axis)
+	template <typename real>
+	physics::projection<real> project_polygon(std::span<const physics::vec_2<real>> vertices, physics::vec_2<real> axis)
 	{
-		physics::projection projection {};
+		physics::projection<real> projection {};
 
 		for (size_t i = 0; i < vertices.size(); i++)
 		{
-			double dot = vec_dot(vertices[i], axis);
+			real dot = vec_dot(vertices[i], axis);
 			
 			if (dot < projection.min)
 				projection.min = dot;
@@ -39,14 +62,15 @@ namespace physics
 		return projection;
 	}
 
-	physics::projection project_circle(physics::vec_2d center, double radius, physics::vec_2d axis)
+	template <typename real>
+	physics::projection<real> project_circle(physics::vec_2<real> center, real radius, physics::vec_2<real> axis)
 	{
-		physics::vec_2d circle_product = vec_mul(axis, radius);
+		physics::vec_2<real> circle_product = vec_mul(axis, radius);
 
-		physics::vec_2d point_a = vec_sub(center, circle_product);
-		physics::vec_2d point_b = vec_add(center, circle_product);
+		physics::vec_2<real> point_a = vec_sub(center, circle_product);
+		physics::vec_2<real> point_b = vec_add(center, circle_product);
 		
-		physics::projection projection;
+		physics::projection<real> projection;
 		projection.min = vec_dot(point_a, axis);
 		projection.max = vec_dot(point_b, axis);
 
@@ -56,29 +80,32 @@ namespace physics
 		return projection;
 	}
 
-	bool projection_overlap(physics::projection a, physics::projection b)
+	template <typename real>
+	bool projection_overlap(physics::projection<real> a, physics::projection<real> b)
 	{
 		return !(b.max <= a.min || a.max <= b.min);
 	}
 
+	template <typename real>
 	struct point_segment_info
 	{
-		double distance_squared { DBL_MAX };
-		physics::vec_2d point {};
+		real distance_squared { std::numeric_limits<real>::max() };
+		physics::vec_2<real> point {};
 	};
 
 	// Finds the closest point on a line to another point
-	physics::point_segment_info get_closest_point(physics::vec_2d point, physics::vec_2d vertex_a, physics::vec_2d vertex_b)
+	template <typename real>
+	physics::point_segment_info<real> get_closest_point(physics::vec_2<real> point, physics::vec_2<real> vertex_a, physics::vec_2<real> vertex_b)
 	{
-		physics::vec_2d vertex_diff = vec_sub(vertex_b, vertex_a);
-		physics::vec_2d origin_diff = vec_sub(point, vertex_a);
+		physics::vec_2<real> vertex_diff = vec_sub(vertex_b, vertex_a);
+		physics::vec_2<real> origin_diff = vec_sub(point, vertex_a);
 
-		double projection = vec_dot(vertex_diff, origin_diff);
-		double length_sq = vec_dot(vertex_diff, vertex_diff);
+		real projection = vec_dot(vertex_diff, origin_diff);
+		real length_sq = vec_dot(vertex_diff, vertex_diff);
 
-		physics::point_segment_info point_info {};
+		physics::point_segment_info<real> point_info {};
 
-		if (projection <= 0.0)
+		if (projection <= 0)
 		{
 			point_info.point = vertex_a;
 		}
@@ -96,154 +123,188 @@ namespace physics
 		return point_info;
 	}
 
-	// Collision between two polygons using seperate axis theorem
-	bool get_polygon_collision(const std::vector<physics::vec_2d>& vertices_a, physics::vec_2d origin_a, const std::vector<physics::vec_2d>& vertices_b, physics::vec_2d origin_b, physics::collision_manifold& collision)
+	// Polygon edge normals point outwards when multiplied by this, they point inwards for counter-clockwise polygons
+	template <typename real>
+	real get_outward_sign(std::span<const physics::vec_2<real>> vertices, std::span<const physics::vec_2<real>> normals, physics::vec_2<real> origin)
+	{
+		return vec_dot(normals[0], vec_sub(vertices[0], origin)) > 0 ? real(1) : real(-1);
+	}
+
+	template <typename real>
+	struct edge_separation
+	{
+		size_t edge { 0 };
+		real separation { -std::numeric_limits<real>::max() };
+	};
+
+	// Finds the edge of polygon a that polygon b is furthest in front of, measured along the edge's outward normal
+	// The search stops early once a separating edge is found
+	template <typename real>
+	physics::edge_separation<real> find_max_separation(std::span<const physics::vec_2<real>> vertices_a, std::span<const physics::vec_2<real>> normals_a, real outward_a, std::span<const physics::vec_2<real>> vertices_b)
 	{
-		double depth = DBL_MAX;
-		physics::vec_2d normal{};
+		physics::edge_separation<real> max_separation {};
 
 		for (size_t i = 0; i < vertices_a.size(); i++)
 		{
-			const physics::vec_2d current_point = vertices_a[i];
-			const physics::vec_2d next_point = vertices_a[(i + 1) % vertices_a.size()];
-			const physics::vec_2d axis_normalized = calculate_axis(current_point, next_point);
+			physics::vec_2<real> normal = vec_mul(normals_a[i], outward_a);
+			real separation = std::numeric_limits<real>::max();
 
-			physics::projection projection_a = project_polygon(vertices_a, axis_normalized);
-			physics::projection projection_b = project_polygon(vertices_b, axis_normalized);
+			for (size_t j = 0; j < vertices_b.size(); j++)
+				separation = std::min(separation, vec_dot(normal, vec_sub(vertices_b[j], vertices_a[i])));
 
-			if (projection_overlap(projection_a, projection_b))
+			if (separation > max_separation.separation)
 			{
-				double axis_depth = std::min(projection_b.max - projection_a.min, projection_a.max - projection_b.min);
+				max_separation.edge = i;
+				max_separation.separation = separation;
 
-				if (axis_depth < depth)
-				{
-					depth = axis_depth;
-					normal = axis_normalized;
-				}
-			}
-			else
-			{
-				return false;
+				if (separation >= 0)
+					break;
 			}
 		}
 
-		for (size_t i = 0; i < vertices_b.size(); i++)
-		{
-			const physics::vec_2d current_point = vertices_b[i];
-			const physics::vec_2d next_point = vertices_b[(i + 1) % vertices_b.size()];
-			const physics::vec_2d axis_normalized = calculate_axis(current_point, next_point);
+		return max_separation;
+	}
 
-			physics::projection projection_a = project_polygon(vertices_a, axis_normalized);
-			physics::projection projection_b = project_polygon(vertices_b, axis_normalized);
+	template <typename real>
+	struct clip_vertex
+	{
+		physics::vec_2<real> point {};
+		uint32_t feature_id { 0 };
+	};
 
-			if (projection_overlap(projection_a, projection_b))
-			{
-				double axis_depth = std::min(projection_b.max - projection_a.min, projection_a.max - projection_b.min);
+	// Clips a segment to the side of a plane where dot(normal, point) <= offset (Sutherland-Hodgman)
+	// A point created by the clip gets the given feature id, returns the number of points left
+	template <typename real>
+	size_t clip_segment(physics::clip_vertex<real> (&points)[2], physics::vec_2<real> normal, real offset, uint32_t clip_feature_id)
+	{
+		physics::clip_vertex<real> clipped[2] {};
+		size_t count = 0;
 
-				if (axis_depth < depth)
-				{
-					depth = axis_depth;
-					normal = axis_normalized;
-				}
-			}
-			else
-			{
-				return false;
-			}
+		real distance_a = vec_dot(normal, points[0].point) - offset;
+		real distance_b = vec_dot(normal, points[1].point) - offset;
+
+		if (distance_a <= 0)
+			clipped[count++] = points[0];
+
+		if (distance_b <= 0)
+			clipped[count++] = points[1];
+
+		// The points are on opposite sides, so the segment crosses the plane
+		if (distance_a * distance_b < 0)
+		{
+			real t = distance_a / (distance_a - distance_b);
+			clipped[count++] = { vec_add(points[0].point, vec_mul(vec_sub(points[1].point, points[0].point), t)), clip_feature_id };
 		}
 
-		physics::vec_2d direction = vec_sub(origin_a, origin_b);
+		points[0] = clipped[0];
+		points[1] = clipped[1];
 
-		size_t num_contacts = 0;
-		physics::vec_2d contact_a {};
-		physics::vec_2d contact_b {};
+		return count;
+	}
 
-		double closest_distance = DBL_MAX;
+	// Collision between two polygons using seperate axis theorem
+	// The edge normals are the separating axes, so they are precomputed rather than normalized here
+	// Contact points come from clipping the incident edge to the reference edge (the edge of least penetration), so only O(n + m) work follows the axis tests
+	template <typename real>
+	bool get_polygon_collision(std::span<const physics::vec_2<real>> vertices_a, std::span<const physics::vec_2<real>> normals_a, physics::vec_2<real> origin_a, std::span<const physics::vec_2<real>> vertices_b, std::span<const physics::vec_2<real>> normals_b, physics::vec_2<real> origin_b, physics::basic_collision_manifold<real>& collision)
+	{
+		real outward_a = get_outward_sign(vertices_a, normals_a, origin_a);
+		real outward_b = get_outward_sign(vertices_b, normals_b, origin_b);
 
-		for (size_t i = 0; i < vertices_a.size(); i++)
-		{
-			physics::vec_2d point_a = vertices_a[i];
+		physics::edge_separation<real> edge_a = find_max_separation(vertices_a, normals_a, outward_a, vertices_b);
+		if (edge_a.separation >= 0)
+			return false;
 
-			for (size_t j = 0; j < vertices_b.size(); j++)
-			{
-				const physics::vec_2d current_point = vertices_b[j];
-				const physics::vec_2d next_point = vertices_b[(j + 1) % vertices_b.size()];
+		physics::edge_separation<real> edge_b = find_max_separation(vertices_b, normals_b, outward_b, vertices_a);
+		if (edge_b.separation >= 0)
+			return false;
 
-				physics::point_segment_info point_info = get_closest_point(point_a, current_point, next_point);
+		// Edges of a are preferred, so the reference edge doesn't alternate between two nearly equal edges every step
+		real distance = std::max(std::abs(origin_a.x), std::abs(origin_a.y));
+		real tolerance = physics::reference_edge_tolerance<real> + physics::reference_edge_relative_tolerance<real> * distance;
+		bool flipped = edge_b.separation > edge_a.separation + tolerance;
 
-				if (physics::equals(point_info.distance_squared, closest_distance))
-				{
-					if (physics::vec_equals(contact_a, point_info.point))
-						continue;
+		std::span<const physics::vec_2<real>> reference_vertices = flipped ? vertices_b : vertices_a;
+		std::span<const physics::vec_2<real>> incident_vertices = flipped ? vertices_a : vertices_b;
+		std::span<const physics::vec_2<real>> incident_normals = flipped ? normals_a : normals_b;
+		real incident_outward = flipped ? outward_a : outward_b;
 
-					num_contacts = 2;
-					contact_b = point_info.point;
-				}
-				else if (point_info.distance_squared < closest_distance)
-				{
-					num_contacts = 1;
-					contact_a = point_info.point;
-					closest_distance = point_info.distance_squared;
-				}
-			}
-		}
+		size_t reference_edge = flipped ? edge_b.edge : edge_a.edge;
+		real separation = flipped ? edge_b.separation : edge_a.separation;
+		physics::vec_2<real> normal = vec_mul(flipped ? normals_b[reference_edge] : normals_a[reference_edge], flipped ? outward_b : outward_a);
+
+		// The incident edge is the edge of the other polygon facing the reference edge the most
+		size_t incident_edge = 0;
+		real min_dot = std::numeric_limits<real>::max();
 
-		for (size_t i = 0; i < vertices_b.size(); i++)
+		for (size_t i = 0; i < incident_vertices.size(); i++)
 		{
-			physics::vec_2d point_a = vertices_b[i];
+			real dot = vec_dot(vec_mul(incident_normals[i], incident_outward), normal);
 
-			for (size_t j = 0; j < vertices_a.size(); j++)
+			if (dot < min_dot)
 			{
-				const physics::vec_2d current_point = vertices_a[j];
-				const physics::vec_2d next_point = vertices_a[(j + 1) % vertices_a.size()];
+				min_dot = dot;
+				incident_edge = i;
+			}
+		}
 
-				physics::point_segment_info point_info = get_closest_point(point_a, current_point, next_point);
+		size_t reference_index_a = reference_edge;
+		size_t reference_index_b = reference_edge + 1 == reference_vertices.size() ? 0 : reference_edge + 1;
+		size_t incident_index_a = incident_edge;
+		size_t incident_index_b = incident_edge + 1 == incident_vertices.size() ? 0 : incident_edge + 1;
 
-				if (physics::equals(point_info.distance_squared, closest_distance))
-				{
-					if (physics::vec_equals(contact_a, point_info.point))
-						continue;
+		physics::vec_2<real> reference_a = reference_vertices[reference_index_a];
+		physics::vec_2<real> reference_b = reference_vertices[reference_index_b];
+		physics::vec_2<real> tangent = vec_normalize(vec_sub(reference_b, reference_a));
 
-					num_contacts = 2;
-					contact_b = point_info.point;
-				}
-				else if (point_info.distance_squared < closest_distance)
-				{
-					num_contacts = 1;
-					contact_a = point_info.point;
-					closest_distance = point_info.distance_squared;
-				}
-			}
-		}
+		// Incident vertices belong to b unless the polygons were flipped, points created by clipping are at the reference vertices
+		physics::clip_vertex<real> points[2] = {
+			{ incident_vertices[incident_index_a], make_feature_id(!flipped, incident_index_a, reference_edge) },
+			{ incident_vertices[incident_index_b], make_feature_id(!flipped, incident_index_b, reference_edge) }
+		};
 
-		collision.depth = depth;
-		collision.normal = normal;
+		// Clip the incident edge to the side planes of the reference edge
+		if (clip_segment(points, vec_mul(tangent, -1), -vec_dot(tangent, reference_a), make_feature_id(flipped, reference_index_a, incident_edge)) < 2)
+			return false;
 
-		collision.contact_points.push_back(contact_a);
-		if (num_contacts == 2)
-			collision.contact_points.push_back(contact_b);
+		if (clip_segment(points, tangent, vec_dot(tangent, reference_b), make_feature_id(flipped, reference_index_b, incident_edge)) < 2)
+			return false;
 
-		return true;
+		// The normal points from a to b
+		collision.normal = flipped ? vec_mul(normal, -1) : normal;
+		collision.depth = -separation;
+
+		// Keep the points behind the reference edge, halfway between the edges
+		real reference_offset = vec_dot(normal, reference_a);
+
+		for (const physics::clip_vertex<real>& point : points)
+		{
+			real point_separation = vec_dot(normal, point.point) - reference_offset;
+
+			if (point_separation <= 0)
+				collision.add_point(vec_sub(point.point, vec_mul(normal, real(0.5) * point_separation)), -point_separation, point.feature_id);
+		}
+
+		return collision.point_count > 0;
 	}
 
 	// Collision between polygon and circle using seperate axis theorem
-	bool get_polygon_circle_collision(const std::vector<physics::vec_2d>& vertices, physics::vec_2d polygon_origin, physics::vec_2d circle_origin, double circle_radius, physics::collision_manifold& collision)
+	template <typename real>
+	bool get_polygon_circle_collision(std::span<const physics::vec_2<real>> vertices, std::span<const physics::vec_2<real>> normals, physics::vec_2<real> polygon_origin, physics::vec_2<real> circle_origin, real circle_radius, physics::basic_collision_manifold<real>& collision)
 	{
-		double depth = DBL_MAX;
-		physics::vec_2d normal{};
+		real depth = std::numeric_limits<real>::max();
+		physics::vec_2<real> normal{};
 
 		for (size_t i = 0; i < vertices.size(); i++)
 		{
-			const physics::vec_2d current_point = vertices[i];
-			const physics::vec_2d next_point = vertices[(i + 1) % vertices.size()];
-			const physics::vec_2d axis_normalized = calculate_axis(current_point, next_point);
+			const physics::vec_2<real> axis_normalized = normals[i];
 
-			physics::projection projection_a = project_polygon(vertices, axis_normalized);
-			physics::projection projection_b = project_circle(circle_origin, circle_radius, axis_normalized);
+			physics::projection<real> projection_a = project_polygon(vertices, axis_normalized);
+			physics::projection<real> projection_b = project_circle(circle_origin, circle_radius, axis_normalized);
 
 			if (projection_overlap(projection_a, projection_b))
 			{
-				double axis_depth = std::min(projection_b.max - projection_a.min, projection_a.max - projection_b.min);
+				real axis_depth = std::min(projection_b.max - projection_a.min, projection_a.max - projection_b.min);
 
 				if (axis_depth < depth)
 				{
@@ -257,15 +318,15 @@ namespace physics
 			}
 		}
 
-		double closest_distance{ DBL_MAX };
+		real closest_distance{ std::numeric_limits<real>::max() };
 		size_t closest_index{};
 
 		for (size_t i = 0; i < vertices.size(); i++)
 		{
-			double dx = vertices[i].x - circle_origin.x;
-			double dy = vertices[i].y - circle_origin.y;
+			real dx = vertices[i].x - circle_origin.x;
+			real dy = vertices[i].y - circle_origin.y;
 
-			double distance_sq = dx * dx + dy * dy;
+			real distance_sq = dx * dx + dy * dy;
 
 			if (distance_sq < closest_distance)
 			{
@@ -274,18 +335,18 @@ namespace physics
 			}
 		}
 
-		physics::vec_2d closest_vertex = vertices[closest_index];
-		physics::vec_2d axis = vec_sub(closest_vertex, circle_origin);
+		physics::vec_2<real> closest_vertex = vertices[closest_index];
+		physics::vec_2<real> axis = vec_sub(closest_vertex, circle_origin);
 			
-		double magnitude = std::hypot(axis.x, axis.y);
+		real magnitude = std::sqrt(axis.x * axis.x + axis.y * axis.y);
 		axis = { axis.x / magnitude, axis.y / magnitude };
 
-		physics::projection polygon_projection = project_polygon(vertices, axis);
-		physics::projection circle_projection = project_circle(circle_origin, circle_radius, axis);
+		physics::projection<real> polygon_projection = project_polygon(vertices, axis);
+		physics::projection<real> circle_projection = project_circle(circle_origin, circle_radius, axis);
 
 		if (projection_overlap(polygon_projection, circle_projection))
 		{
-			double axis_depth = std::min(circle_projection.max - polygon_projection.min, polygon_projection.max - circle_projection.min);
+			real axis_depth = std::min(circle_projection.max - polygon_projection.min, polygon_projection.max - circle_projection.min);
 
 			if (axis_depth < depth)
 			{
@@ -298,25 +359,27 @@ namespace physics
 			return false;
 		}
 
-		physics::vec_2d direction = vec_sub(polygon_origin, circle_origin);
+		physics::vec_2<real> direction = vec_sub(polygon_origin, circle_origin);
 
-		physics::point_segment_info closest_point;
-		closest_point.distance_squared = DBL_MAX;
+		physics::point_segment_info<real> closest_point;
+		closest_point.distance_squared = std::numeric_limits<real>::max();
+		size_t closest_edge = 0;
 
 		for (size_t i = 0; i < vertices.size(); i++)
 		{
-			const physics::vec_2d current_point = vertices[i];
-			const physics::vec_2d next_point = vertices[(i + 1) % vertices.size()];
+			const physics::vec_2<real> current_point = vertices[i];
+			const physics::vec_2<real> next_point = vertices[(i + 1) % vertices.size()];
 
-			physics::point_segment_info point_info = get_closest_point(circle_origin, current_point, next_point);
+			physics::point_segment_info<real> point_info = get_closest_point(circle_origin, current_point, next_point);
 
 			if (point_info.distance_squared < closest_point.distance_squared)
 			{
 				closest_point = point_info;
+				closest_edge = i;
 			}
 		}
 
-		collision.contact_points.push_back(closest_point.point);
+		collision.add_point(closest_point.point, depth, make_feature_id(false, 0, closest_edge));
 		collision.depth = depth;
 		collision.normal = normal;
 
@@ -324,10 +387,11 @@ namespace physics
 	}
 
 	// Collisions between two circles
-	bool get_circle_collision(physics::vec_2d origin_a, double radius_a, physics::vec_2d origin_b, double radius_b, physics::collision_manifold& collision)
+	template <typename real>
+	bool get_circle_collision(physics::vec_2<real> origin_a, real radius_a, physics::vec_2<real> origin_b, real radius_b, physics::basic_collision_manifold<real>& collision)
 	{
-		double center_distance = physics::get_distance(origin_a, origin_b);
-		double combined_radius = radius_a + radius_b;
+		real center_distance = physics::get_distance(origin_a, origin_b);
+		real combined_radius = radius_a + radius_b;
 
 		bool collided = center_distance <= combined_radius;
 
@@ -336,8 +400,8 @@ namespace physics
 			collision.depth = combined_radius - center_distance;
 			collision.normal = vec_normalize(vec_sub(origin_b, origin_a));
 
-			physics::vec_2d collision_point = vec_sub(origin_b, vec_mul(collision.normal, radius_b));
-			collision.contact_points.push_back(collision_point);
+			physics::vec_2<real> collision_point = vec_sub(origin_b, vec_mul(collision.normal, radius_b));
+			collision.add_point(collision_point, collision.depth, 0);
 
 			return true;
 		}
@@ -345,61 +409,80 @@ namespace physics
 		return false;
 	}
 
-	bool get_collision(physics::body* body_a, physics::body* body_b, physics::collision_manifold& collision)
+	template <typename real>
+	physics::basic_shape_view<real> get_shape_view(physics::basic_body<real>* body)
 	{
-		collision.body_a = body_a;
-		collision.body_b = body_b;
+		const physics::basic_shape<real>* shape = body->get_shape();
 
-		const physics::shape* shape_a = body_a->get_shape();
-		const physics::shape* shape_b = body_b->get_shape();
+		physics::basic_shape_view<real> view {};
+		view.type = shape->get_type();
+		view.origin = body->get_position();
 
-		physics::shape_type type_a = shape_a->get_type();
-		physics::shape_type type_b = shape_b->get_type();
+		if (view.type == physics::shape_type::polygon || view.type == physics::shape_type::rounded_polygon)
+		{
+			view.vertices = body->get_translated_vertices();
+			view.normals = body->get_translated_normals();
+		}
 
-		physics::vec_2d origin_a = body_a->get_position();
-		double rotation_a = body_a->get_rotation();
+		if (view.type == physics::shape_type::circle)
+			view.radius = static_cast<const physics::basic_circle<real>*>(shape)->get_radius();
+		else if (view.type == physics::shape_type::rounded_polygon)
+			view.radius = static_cast<const physics::basic_rounded_polygon<real>*>(shape)->get_radius();
 
-		physics::vec_2d origin_b = body_b->get_position();
-		double rotation_b = body_b->get_rotation();
+		return view;
+	}
+
+	template <typename real>
+	bool get_collision(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::basic_collision_manifold<real>& collision)
+	{
+		// Rounded shapes and large polygons only need support points, so GJK tests them in O(n + m)
+		bool gjk_a = shape_a.type == physics::shape_type::rounded_polygon || shape_a.vertices.size() > physics::sat_max_vertices;
+		bool gjk_b = shape_b.type == physics::shape_type::rounded_polygon || shape_b.vertices.size() > physics::sat_max_vertices;
+
+		if (gjk_a || gjk_b)
+			return get_gjk_collision(shape_a, shape_b, collision);
 
 		// Check each shape type and call the according collision function
-		if (type_a == physics::shape_type::polygon && type_b == physics::shape_type::polygon)
+		if (shape_a.type == physics::shape_type::polygon && shape_b.type == physics::shape_type::polygon)
 		{
 			// Polygon-polygon collision check
-			std::vector<physics::vec_2d> vertices_a = body_a->get_translated_vertices();
-			std::vector<physics::vec_2d> vertices_b = body_b->get_translated_vertices();
-
-			return get_polygon_collision(vertices_a, origin_a, vertices_b, origin_b, collision);
+			return get_polygon_collision(shape_a.vertices, shape_a.normals, shape_a.origin, shape_b.vertices, shape_b.normals, shape_b.origin, collision);
 		}
-		else if (type_a == physics::shape_type::polygon && type_b == physics::shape_type::circle)
+		else if (shape_a.type == physics::shape_type::polygon && shape_b.type == physics::shape_type::circle)
 		{
 			// Polygon-circle collision check
-			std::vector<physics::vec_2d> vertices = body_a->get_translated_vertices();
-
-			double radius = static_cast<const physics::circle*>(shape_b)->get_radius();
-
-			return get_polygon_circle_collision(vertices, origin_a, origin_b, radius, collision);
+			return get_polygon_circle_collision(shape_a.vertices, shape_a.normals, shape_a.origin, shape_b.origin, shape_b.radius, collision);
 		}
-		else if (type_a == physics::shape_type::circle && type_b == physics::shape_type::polygon)
+		else if (shape_a.type == physics::shape_type::circle && shape_b.type == physics::shape_type::polygon)
 		{
 			// Polygon-circle collision check
-
-			double radius = static_cast<const physics::circle*>(shape_a)->get_radius();
-
-			std::vector<physics::vec_2d> vertices = body_b->get_translated_vertices();
-
-			return get_polygon_circle_collision(vertices, origin_b, origin_a, radius, collision);
+			return get_polygon_circle_collision(shape_b.vertices, shape_b.normals, shape_b.origin, shape_a.origin, shape_a.radius, collision);
 		}
-		else if (type_a == physics::shape_type::circle && type_b == physics::shape_type::circle)
+		else if (shape_a.type == physics::shape_type::circle && shape_b.type == physics::shape_type::circle)
 		{
 			// Circle-circle collision check
-
-			double radius_a = static_cast<const physics::circle*>(shape_a)->get_radius();
-			double radius_b = static_cast<const physics::circle*>(shape_b)->get_radius();
-
-			return get_circle_collision(origin_a, radius_a, origin_b, radius_b, collision);
+			return get_circle_collision(shape_a.origin, shape_a.radius, shape_b.origin, shape_b.radius, collision);
 		}
 
 		return false;
 	}
+
+	template <typename real>
+	bool get_collision(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b, physics::basic_collision_manifold<real>& collision)
+	{
+		collision.body_a = body_a;
+		collision.body_b = body_b;
+
+		return get_collision(get_shape_view(body_a), get_shape_view(body_b), collision);
+	}
+
+	template struct basic_collision_manifold<float>;
+	template physics::basic_shape_view<float> get_shape_view<float>(physics::basic_body<float>*);
+	template bool get_collision<float>(const physics::basic_shape_view<float>&, const physics::basic_shape_view<float>&, physics::basic_collision_manifold<float>&);
+	template bool get_collision<float>(physics::basic_body<float>*, physics::basic_body<float>*, physics::basic_collision_manifold<float>&);
+
+	template struct basic_collision_manifold<double>;
+	template physics::basic_shape_view<double> get_shape_view<double>(physics::basic_body<double>*);
+	template bool get_collision<double>(const physics::basic_shape_view<double>&, const physics::basic_shape_view<double>&, physics::basic_collision_manifold<double>&);
+	template bool get_collision<double>(physics::basic_body<double>*, physics::basic_body<double>*, physics::basic_collision_manifold<double>&);
 }
\ No newline at end of file
@@ -1,24 +1,75 @@
 #pragma once
 
+#include <span>
 #include "body.h"
 
 namespace physics
 {
-	struct collision_manifold
+	// Contact points are stored inline so manifolds never allocate and can be copied freely
+	template <typename real>
+	struct basic_collision_manifold
 	{
+		// Two shapes in 2D touch at a single point or along an edge
+		static constexpr size_t max_points = 2;
+
 		// Bodies involved in the collision
-		physics::body* body_a { nullptr };
-		physics::body* body_b { nullptr };
+		physics::basic_body<real>* body_a { nullptr };
+		physics::basic_body<real>* body_b { nullptr };
 
 		// Collision normal and depth
-		physics::vec_2d normal {};
-		double depth { 0.0 };
+		physics::vec_2<real> normal {};
+		real depth { 0 };
+
+		// Contact points, only the first point_count are valid
+		size_t point_count { 0 };
+		physics::vec_2<real> contact_points[max_points] {};
+
+		// Penetration depth at each contact point
+		real depths[max_points] {};
+
+		// Identifies the features (vertex and edge) that produced each contact point
+		// Used to match contact points between steps
+		uint32_t feature_ids[max_points] {};
 
-		// List of contact points
-		std::vector<physics::vec_2d> contact_points {};
+		// Adds a contact point, ignored if the manifold is full
+		void add_point(physics::vec_2<real> point, real point_depth, uint32_t feature_id);
 	};
 
+	using collision_manifold = basic_collision_manifold<double>;
+
+	// Feature id for a contact point where a vertex of one shape touches an edge of the other
+	// flipped is true when the vertex belongs to body b
+	uint32_t make_feature_id(bool flipped, size_t vertex_index, size_t edge_index);
+
+	// Non-owning view of a shape in world space, the narrow phase works on these so testing a pair never copies or allocates
+	template <typename real>
+	struct basic_shape_view
+	{
+		physics::shape_type type { physics::shape_type::none };
+		physics::vec_2<real> origin {};
+
+		// World space vertices and unit edge normals of polygons and rounded polygons
+		std::span<const physics::vec_2<real>> vertices {};
+		std::span<const physics::vec_2<real>> normals {};
+
+		// Radius of circles and rounded polygons
+		real radius { 0 };
+	};
+
+	using shape_view = basic_shape_view<double>;
+
+	// Get a view of a body's shape
+	// Polygon vertices point to the body's translated vertices, so the view is only valid until the body's shape is next updated
+	template <typename real>
+	physics::basic_shape_view<real> get_shape_view(physics::basic_body<real>* body);
+
+	// Checks for a collision between two shapes, the bodies of the manifold are left unchanged
+	// Returns true if a collision was detected
+	template <typename real>
+	bool get_collision(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::basic_collision_manifold<real>& collision);
+
 	// Checks for a collision between two bodies
 	// Returns true if a collision was detected
-	bool get_collision(physics::body* body_a, physics::body* body_b, physics::collision_manifold& collision);
+	template <typename real>
+	bool get_collision(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b, physics::basic_collision_manifold<real>& collision);
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "contact_cache.h"
+#include "body.h"
+#include <algorithm>
+
+namespace physics
+{
+	bool contact_key::operator==(const contact_key& other) const
+	{
+		return id_a == other.id_a && id_b == other.id_b;
+	}
+
+	size_t contact_key_hash::operator()(const contact_key& key) const
+	{
+		// Combine the ids the same way as boost::hash_combine
+		size_t hash = std::hash<size_t>()(key.id_a);
+		hash ^= std::hash<size_t>()(key.id_b) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	template <typename real>
+	contact_key make_contact_key(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b)
+	{
+		size_t id_a = body_a->get_id();
+		size_t id_b = body_b->get_id();
+
+		if (id_a < id_b)
+			return { id_a, id_b };
+
+		return { id_b, id_a };
+	}
+
+	// Static and sleeping bodies don't move
+	template <typename real>
+	bool is_body_moving(const physics::basic_body<real>* body)
+	{
+		return body->get_type() != physics::static_body && !body->is_sleeping();
+	}
+
+	template <typename real>
+	physics::basic_contact_cache_entry<real>& basic_contact_cache<real>::get_entry(const physics::contact_key& key)
+	{
+		auto it = entries.find(key);
+		if (it != entries.end())
+			return it->second;
+
+		if (free_entries.empty())
+			return entries[key];
+
+		typename entry_map::node_type node = std::move(free_entries.back());
+		free_entries.pop_back();
+
+		node.key() = key;
+		node.mapped() = physics::basic_contact_cache_entry<real> {};
+
+		return entries.insert(std::move(node)).position->second;
+	}
+
+	template <typename real>
+	void basic_contact_cache<real>::evict(typename entry_map::iterator it)
+	{
+		free_entries.push_back(entries.extract(it));
+	}
+
+	template <typename real>
+	const physics::basic_contact_cache_entry<real>* basic_contact_cache<real>::find(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b) const
+	{
+		auto it = entries.find(make_contact_key(body_a, body_b));
+		if (it == entries.end())
+			return nullptr;
+
+		return &it->second;
+	}
+
+	template <typename real>
+	bool basic_contact_cache<real>::get_unchanged_collision(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b, physics::basic_collision_manifold<real>& collision) const
+	{
+		const physics::basic_contact_cache_entry<real>* entry = find(body_a, body_b);
+		if (!entry || !entry->touching || entry->touch_step != step_index)
+			return false;
+
+		// The manifold may have been found with the bodies in the opposite order
+		if (entry->manifold.body_a != body_a)
+			return false;
+
+		// Exact comparison, otherwise small movements would add up without the manifold being updated
+		physics::vec_2<real> position_a = body_a->get_position();
+		physics::vec_2<real> position_b = body_b->get_position();
+
+		if (position_a.x != entry->position_a.x || position_a.y != entry->position_a.y || body_a->get_rotation() != entry->rotation_a)
+			return false;
+
+		if (position_b.x != entry->position_b.x || position_b.y != entry->position_b.y || body_b->get_rotation() != entry->rotation_b)
+			return false;
+
+		collision = entry->manifold;
+		return true;
+	}
+
+	template <typename real>
+	void basic_contact_cache<real>::warm_start(const physics::basic_collision_manifold<real>& collision, physics::basic_contact_constraint<real>& constraint) const
+	{
+		const physics::basic_contact_cache_entry<real>* entry = find(collision.body_a, collision.body_b);
+		if (!entry || !entry->touching)
+			return;
+
+		for (size_t i = 0; i < collision.point_count; i++)
+		{
+			for (size_t j = 0; j < entry->manifold.point_count; j++)
+			{
+				if (entry->manifold.feature_ids[j] != collision.feature_ids[i])
+					continue;
+
+				constraint.points[i].normal_impulse = entry->normal_impulses[j];
+				constraint.points[i].tangent_impulse = entry->tangent_impulses[j];
+				break;
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_contact_cache<real>::update(const std::vector<physics::basic_body_pair<real>>& pairs, const std::vector<physics::basic_collision_manifold<real>>& contacts, const std::vector<physics::basic_contact_constraint<real>>& constraints, std::vector<physics::basic_contact_event<real>>& events)
+	{
+		step_index++;
+
+		for (const physics::basic_body_pair<real>& pair : pairs)
+			get_entry(make_contact_key(pair.body_a, pair.body_b)).overlap_step = step_index;
+
+		// Contacts are sorted by body id pair, so begin events are too
+		for (size_t i = 0; i < contacts.size(); i++)
+		{
+			const physics::basic_collision_manifold<real>& collision = contacts[i];
+			const physics::basic_contact_constraint<real>& constraint = constraints[i];
+
+			physics::basic_contact_cache_entry<real>& entry = get_entry(make_contact_key(collision.body_a, collision.body_b));
+
+			if (!entry.touching)
+				events.push_back({ physics::contact_event_type::begin, collision.body_a, collision.body_b });
+
+			entry.manifold = collision;
+			entry.touching = true;
+			entry.touch_step = step_index;
+
+			entry.position_a = collision.body_a->get_position();
+			entry.position_b = collision.body_b->get_position();
+			entry.rotation_a = collision.body_a->get_rotation();
+			entry.rotation_b = collision.body_b->get_rotation();
+
+			for (size_t j = 0; j < constraint.point_count; j++)
+			{
+				entry.normal_impulses[j] = constraint.points[j].normal_impulse;
+				entry.tangent_impulses[j] = constraint.points[j].tangent_impulse;
+			}
+		}
+
+		evicted_keys.clear();
+		end_events.clear();
+
+		for (auto& [key, entry] : entries)
+		{
+			if (entry.overlap_step == step_index && (entry.touch_step == step_index || !entry.touching))
+				continue;
+
+			// Only pairs with a moving body are tested, the others keep their state until one of them wakes
+			if (entry.touching && !is_body_moving(entry.manifold.body_a) && !is_body_moving(entry.manifold.body_b))
+				continue;
+
+			if (entry.touching)
+			{
+				end_events.push_back({ physics::contact_event_type::end, entry.manifold.body_a, entry.manifold.body_b });
+				entry.touching = false;
+			}
+
+			if (entry.overlap_step != step_index)
+				evicted_keys.push_back(key);
+		}
+
+		for (const physics::contact_key& key : evicted_keys)
+			evict(entries.find(key));
+
+		// Map iteration order depends on the insertion history, sort so events are deterministic
+		std::sort(end_events.begin(), end_events.end(), [](const physics::basic_contact_event<real>& a, const physics::basic_contact_event<real>& b)
+		{
+			if (a.body_a->get_id() != b.body_a->get_id())
+				return a.body_a->get_id() < b.body_a->get_id();
+
+			return a.body_b->get_id() < b.body_b->get_id();
+		});
+
+		events.insert(events.end(), end_events.begin(), end_events.end());
+	}
+
+	template <typename real>
+	void basic_contact_cache<real>::remove_body(const physics::basic_body<real>* body)
+	{
+		size_t id = body->get_id();
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			auto next = std::next(it);
+
+			if (it->first.id_a == id || it->first.id_b == id)
+				evict(it);
+
+			it = next;
+		}
+	}
+
+	template <typename real>
+	void basic_contact_cache<real>::clear()
+	{
+		entries.clear();
+		free_entries.clear();
+	}
+
+	template <typename real>
+	size_t basic_contact_cache<real>::size() const
+	{
+		return entries.size();
+	}
+
+	template contact_key make_contact_key<float>(const physics::basic_body<float>*, const physics::basic_body<float>*);
+	template contact_key make_contact_key<double>(const physics::basic_body<double>*, const physics::basic_body<double>*);
+	template class basic_contact_cache<float>;
+	template class basic_contact_cache<double>;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "broad_phase.h"
+#include "collision.h"
+#include "contact_solver.h"
+
+namespace physics
+{
+	// Ids of the two bodies of a pair, with the lower id first
+	struct contact_key
+	{
+		size_t id_a { 0 };
+		size_t id_b { 0 };
+
+		bool operator==(const contact_key& other) const;
+	};
+
+	struct contact_key_hash
+	{
+		size_t operator()(const contact_key& key) const;
+	};
+
+	template <typename real>
+	contact_key make_contact_key(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b);
+
+	enum class contact_event_type
+	{
+		// Two bodies started touching
+		begin,
+
+		// Two bodies stopped touching
+		end
+	};
+
+	template <typename real>
+	struct basic_contact_event
+	{
+		physics::contact_event_type type { physics::contact_event_type::begin };
+
+		physics::basic_body<real>* body_a { nullptr };
+		physics::basic_body<real>* body_b { nullptr };
+	};
+
+	// Persistent data of a pair of bodies with overlapping AABBs
+	template <typename real>
+	struct basic_contact_cache_entry
+	{
+		// Manifold from the last step the bodies were touching
+		physics::basic_collision_manifold<real> manifold {};
+		bool touching { false };
+
+		// Accumulated impulses of each contact point, matched to the next step's points by feature id
+		real normal_impulses[physics::basic_contact_constraint<real>::max_points] {};
+		real tangent_impulses[physics::basic_contact_constraint<real>::max_points] {};
+
+		// Transforms of the bodies the manifold was found with
+		physics::vec_2<real> position_a {};
+		physics::vec_2<real> position_b {};
+		real rotation_a { 0 };
+		real rotation_b { 0 };
+
+		// Last step the pair was found by the broad phase
+		uint64_t overlap_step { 0 };
+
+		// Last step the pair was touching
+		uint64_t touch_step { 0 };
+	};
+
+	// Keeps the contact manifold and solver impulses of each pair between steps
+	// Entries are created when the AABBs of two bodies start overlapping and evicted once they stop
+	template <typename real>
+	class basic_contact_cache
+	{
+	private:
+		using entry_map = std::unordered_map<physics::contact_key, physics::basic_contact_cache_entry<real>, physics::contact_key_hash>;
+		entry_map entries {};
+
+		// Nodes of evicted entries, reused for new pairs so pairs that keep starting and stopping to overlap don't allocate
+		std::vector<typename entry_map::node_type> free_entries {};
+
+		uint64_t step_index { 0 };
+
+		// Keys of the entries to evict in the current update
+		std::vector<physics::contact_key> evicted_keys {};
+
+		// End events are collected separately so they can be sorted
+		std::vector<physics::basic_contact_event<real>> end_events {};
+
+		// Finds the entry of a pair, creating it if it doesn't exist
+		physics::basic_contact_cache_entry<real>& get_entry(const physics::contact_key& key);
+
+		void evict(typename entry_map::iterator it);
+
+	public:
+		// Find the entry of a pair (nullptr if the pair is not cached)
+		// Safe to call from several threads while the cache is not being updated
+		const physics::basic_contact_cache_entry<real>* find(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b) const;
+
+		// Returns true and copies the cached manifold if the pair was touching and neither body has moved since
+		bool get_unchanged_collision(const physics::basic_body<real>* body_a, const physics::basic_body<real>* body_b, physics::basic_collision_manifold<real>& collision) const;
+
+		// Copies the impulses of cached contact points with the same feature ids into the constraint
+		void warm_start(const physics::basic_collision_manifold<real>& collision, physics::basic_contact_constraint<real>& constraint) const;
+
+		// Stores the contacts and impulses of a step and evicts pairs that are no longer overlapping
+		// Pairs of static and sleeping bodies are kept since they can't have moved apart
+		// Begin and end events are appended to events, ordered by body id pair
+		void update(const std::vector<physics::basic_body_pair<real>>& pairs, const std::vector<physics::basic_collision_manifold<real>>& contacts, const std::vector<physics::basic_contact_constraint<real>>& constraints, std::vector<physics::basic_contact_event<real>>& events);
+
+		// Evicts every entry of a body
+		void remove_body(const physics::basic_body<real>* body);
+
+		void clear();
+
+		// Get the number of cached pairs
+		size_t size() const;
+	};
+
+	using contact_event = basic_contact_event<double>;
+	using contact_cache_entry = basic_contact_cache_entry<double>;
+	using contact_cache = basic_contact_cache<double>;
+}
\ No newline at end of file
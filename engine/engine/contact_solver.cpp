@@ -0,0 +1,165 @@
+#include "contact_solver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace physics
+{
+	// Tangent perpendicular to a contact normal
+	template <typename real>
+	physics::vec_2<real> get_tangent(physics::vec_2<real> normal)
+	{
+		return { normal.y, -normal.x };
+	}
+
+	// Velocity of a point on a body relative to its origin
+	template <typename real>
+	physics::vec_2<real> get_point_velocity(physics::vec_2<real> velocity, real angular_velocity, physics::vec_2<real> r)
+	{
+		return { velocity.x - angular_velocity * r.y, velocity.y + angular_velocity * r.x };
+	}
+
+	// Applies an impulse at a contact point to both bodies (negated for body a)
+	template <typename real>
+	void apply_contact_impulse(physics::basic_body_storage<real>& storage, const physics::basic_contact_constraint<real>& constraint, const physics::basic_contact_point_constraint<real>& point, physics::vec_2<real> impulse)
+	{
+		if (!constraint.a_static)
+		{
+			size_t index = constraint.index_a;
+			storage.velocity_x[index] -= impulse.x * constraint.inv_mass_a;
+			storage.velocity_y[index] -= impulse.y * constraint.inv_mass_a;
+			storage.angular_velocity[index] -= constraint.inv_inertia_a * vec_cross(point.r_a, impulse);
+		}
+
+		if (!constraint.b_static)
+		{
+			size_t index = constraint.index_b;
+			storage.velocity_x[index] += impulse.x * constraint.inv_mass_b;
+			storage.velocity_y[index] += impulse.y * constraint.inv_mass_b;
+			storage.angular_velocity[index] += constraint.inv_inertia_b * vec_cross(point.r_b, impulse);
+		}
+	}
+
+	// Velocity of body b relative to body a at a contact point
+	template <typename real>
+	physics::vec_2<real> get_relative_velocity(const physics::basic_body_storage<real>& storage, const physics::basic_contact_constraint<real>& constraint, const physics::basic_contact_point_constraint<real>& point)
+	{
+		physics::vec_2<real> velocity_a = get_point_velocity(storage.get_velocity(constraint.index_a), storage.angular_velocity[constraint.index_a], point.r_a);
+		physics::vec_2<real> velocity_b = get_point_velocity(storage.get_velocity(constraint.index_b), storage.angular_velocity[constraint.index_b], point.r_b);
+
+		return vec_sub(velocity_b, velocity_a);
+	}
+
+	template <typename real>
+	void prepare_contact(const physics::basic_body_storage<real>& storage, const physics::basic_collision_manifold<real>& collision, const physics::contact_solver_settings& settings, real dt, physics::basic_contact_constraint<real>& constraint)
+	{
+		constraint.inv_mass_a = constraint.a_static ? 0 : storage.inv_mass[constraint.index_a];
+		constraint.inv_mass_b = constraint.b_static ? 0 : storage.inv_mass[constraint.index_b];
+		constraint.inv_inertia_a = constraint.a_static ? 0 : storage.inv_moment_of_inertia[constraint.index_a];
+		constraint.inv_inertia_b = constraint.b_static ? 0 : storage.inv_moment_of_inertia[constraint.index_b];
+
+		physics::vec_2<real> origin_a = storage.get_position(constraint.index_a);
+		physics::vec_2<real> origin_b = storage.get_position(constraint.index_b);
+
+		// Make the normal point from a to b
+		constraint.normal = collision.normal;
+		if (vec_dot(vec_sub(origin_b, origin_a), constraint.normal) < 0)
+			constraint.normal = vec_mul(constraint.normal, -1);
+
+		physics::basic_material<real> material_a = collision.body_a->get_material();
+		physics::basic_material<real> material_b = collision.body_b->get_material();
+
+		constraint.static_friction = material_a.static_friction * material_b.static_friction;
+		constraint.kinetic_friction = material_a.kinetic_friction * material_b.kinetic_friction;
+		real restitution = material_a.restitution * material_b.restitution;
+
+		physics::vec_2<real> tangent = get_tangent(constraint.normal);
+
+		constraint.point_count = collision.point_count;
+
+		for (size_t i = 0; i < constraint.point_count; i++)
+		{
+			physics::basic_contact_point_constraint<real>& point = constraint.points[i];
+
+			point.r_a = vec_sub(collision.contact_points[i], origin_a);
+			point.r_b = vec_sub(collision.contact_points[i], origin_b);
+
+			real rn_a = vec_cross(point.r_a, constraint.normal);
+			real rn_b = vec_cross(point.r_b, constraint.normal);
+			real normal_mass = constraint.inv_mass_a + constraint.inv_mass_b + constraint.inv_inertia_a * rn_a * rn_a + constraint.inv_inertia_b * rn_b * rn_b;
+			point.normal_mass = normal_mass > 0 ? 1 / normal_mass : 0;
+
+			real rt_a = vec_cross(point.r_a, tangent);
+			real rt_b = vec_cross(point.r_b, tangent);
+			real tangent_mass = constraint.inv_mass_a + constraint.inv_mass_b + constraint.inv_inertia_a * rt_a * rt_a + constraint.inv_inertia_b * rt_b * rt_b;
+			point.tangent_mass = tangent_mass > 0 ? 1 / tangent_mass : 0;
+
+			// Bounce only when bodies approach fast enough, otherwise resting contacts jitter
+			real normal_velocity = vec_dot(get_relative_velocity(storage, constraint, point), constraint.normal);
+			real restitution_bias = normal_velocity < -static_cast<real>(settings.restitution_threshold) ? -restitution * normal_velocity : 0;
+
+			// Push bodies apart by a fraction of the penetration beyond the slop each step
+			real penetration_bias = static_cast<real>(settings.baumgarte) / dt * std::max(collision.depths[i] - static_cast<real>(settings.penetration_slop), real(0));
+
+			point.velocity_bias = std::max(restitution_bias, penetration_bias);
+		}
+	}
+
+	template <typename real>
+	void warm_start_contact(physics::basic_body_storage<real>& storage, const physics::basic_contact_constraint<real>& constraint)
+	{
+		physics::vec_2<real> tangent = get_tangent(constraint.normal);
+
+		for (size_t i = 0; i < constraint.point_count; i++)
+		{
+			const physics::basic_contact_point_constraint<real>& point = constraint.points[i];
+
+			physics::vec_2<real> impulse = vec_add(vec_mul(constraint.normal, point.normal_impulse), vec_mul(tangent, point.tangent_impulse));
+			apply_contact_impulse(storage, constraint, point, impulse);
+		}
+	}
+
+	template <typename real>
+	void solve_contact(physics::basic_body_storage<real>& storage, physics::basic_contact_constraint<real>& constraint)
+	{
+		physics::vec_2<real> tangent = get_tangent(constraint.normal);
+
+		// Friction first, so the normal impulse (which is more important) is solved last
+		for (size_t i = 0; i < constraint.point_count; i++)
+		{
+			physics::basic_contact_point_constraint<real>& point = constraint.points[i];
+
+			real tangent_velocity = vec_dot(get_relative_velocity(storage, constraint, point), tangent);
+			real max_static_friction = constraint.static_friction * point.normal_impulse;
+			real max_kinetic_friction = constraint.kinetic_friction * point.normal_impulse;
+
+			// Keep the accumulated impulse that stops sliding if static friction can supply it,
+			// otherwise the contact slides and the impulse is clamped to the kinetic friction cone
+			real old_impulse = point.tangent_impulse;
+			real impulse = old_impulse - tangent_velocity * point.tangent_mass;
+			point.tangent_impulse = std::abs(impulse) <= max_static_friction ? impulse : std::clamp(impulse, -max_kinetic_friction, max_kinetic_friction);
+
+			apply_contact_impulse(storage, constraint, point, vec_mul(tangent, point.tangent_impulse - old_impulse));
+		}
+
+		for (size_t i = 0; i < constraint.point_count; i++)
+		{
+			physics::basic_contact_point_constraint<real>& point = constraint.points[i];
+
+			real normal_velocity = vec_dot(get_relative_velocity(storage, constraint, point), constraint.normal);
+
+			// Clamp the accumulated impulse (not the increment) so earlier iterations can be undone
+			real old_impulse = point.normal_impulse;
+			point.normal_impulse = std::max(old_impulse + (point.velocity_bias - normal_velocity) * point.normal_mass, real(0));
+
+			apply_contact_impulse(storage, constraint, point, vec_mul(constraint.normal, point.normal_impulse - old_impulse));
+		}
+	}
+
+	template void prepare_contact<float>(const physics::basic_body_storage<float>&, const physics::basic_collision_manifold<float>&, const physics::contact_solver_settings&, float, physics::basic_contact_constraint<float>&);
+	template void warm_start_contact<float>(physics::basic_body_storage<float>&, const physics::basic_contact_constraint<float>&);
+	template void solve_contact<float>(physics::basic_body_storage<float>&, physics::basic_contact_constraint<float>&);
+
+	template void prepare_contact<double>(const physics::basic_body_storage<double>&, const physics::basic_collision_manifold<double>&, const physics::contact_solver_settings&, double, physics::basic_contact_constraint<double>&);
+	template void warm_start_contact<double>(physics::basic_body_storage<double>&, const physics::basic_contact_constraint<double>&);
+	template void solve_contact<double>(physics::basic_body_storage<double>&, physics::basic_contact_constraint<double>&);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "body_storage.h"
+#include "collision.h"
+
+namespace physics
+{
+	struct contact_solver_settings
+	{
+		// Number of times every contact is solved each step
+		int velocity_iterations { 8 };
+
+		// Start each step from the impulses of the previous step
+		bool warm_starting { true };
+
+		// Fraction of the penetration removed each step
+		double baumgarte { 0.2 };
+
+		// Penetration allowed before it is corrected, keeps resting contacts touching
+		double penetration_slop { 0.01 };
+
+		// Closing velocity below which contacts don't bounce
+		double restitution_threshold { 1.0 };
+	};
+
+	// Contact point data for the sequential impulse solver
+	template <typename real>
+	struct basic_contact_point_constraint
+	{
+		// Contact point relative to each body's origin
+		physics::vec_2<real> r_a {};
+		physics::vec_2<real> r_b {};
+
+		// Effective mass along the normal and tangent
+		real normal_mass { 0 };
+		real tangent_mass { 0 };
+
+		// Accumulated impulses (the normal impulse is never negative)
+		real normal_impulse { 0 };
+		real tangent_impulse { 0 };
+
+		// Target separating velocity for restitution and penetration correction
+		real velocity_bias { 0 };
+	};
+
+	// Contact between two bodies for the sequential impulse solver
+	template <typename real>
+	struct basic_contact_constraint
+	{
+		static constexpr size_t max_points = physics::basic_collision_manifold<real>::max_points;
+
+		// Storage slots of the bodies
+		size_t index_a { 0 };
+		size_t index_b { 0 };
+
+		// Static and sleeping bodies have zero inverse mass and are never written
+		bool a_static { false };
+		bool b_static { false };
+
+		real inv_mass_a { 0 };
+		real inv_mass_b { 0 };
+		real inv_inertia_a { 0 };
+		real inv_inertia_b { 0 };
+
+		// Normal pointing from body a to body b
+		physics::vec_2<real> normal {};
+
+		// Static friction holds the contact while the friction impulse stays under its limit
+		// Once that limit is exceeded the contact slides and is held back by kinetic friction
+		real static_friction { 0 };
+		real kinetic_friction { 0 };
+
+		size_t point_count { 0 };
+		physics::basic_contact_point_constraint<real> points[max_points] {};
+	};
+
+	using contact_point_constraint = basic_contact_point_constraint<double>;
+	using contact_constraint = basic_contact_constraint<double>;
+
+	// Calculates the effective masses and velocity biases of a contact
+	// The storage slots and static flags of the constraint must already be set
+	// Accumulated impulses are left unchanged so they can be warm started
+	template <typename real>
+	void prepare_contact(const physics::basic_body_storage<real>& storage, const physics::basic_collision_manifold<real>& collision, const physics::contact_solver_settings& settings, real dt, physics::basic_contact_constraint<real>& constraint);
+
+	// Applies the accumulated impulses of a contact
+	template <typename real>
+	void warm_start_contact(physics::basic_body_storage<real>& storage, const physics::basic_contact_constraint<real>& constraint);
+
+	// Solves the friction and normal impulses of a contact once
+	template <typename real>
+	void solve_contact(physics::basic_body_storage<real>& storage, physics::basic_contact_constraint<real>& constraint);
+}
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "dynamic_tree.h"
+#include <algorithm>
+
+namespace physics
+{
+	template <typename real>
+	bool basic_dynamic_tree<real>::node::is_leaf() const
+	{
+		return child_a == null_node;
+	}
+
+	template <typename real>
+	basic_dynamic_tree<real>::basic_dynamic_tree(real margin_ratio)
+		: margin_ratio(margin_ratio)
+	{}
+
+	template <typename real>
+	int32_t basic_dynamic_tree<real>::allocate_node()
+	{
+		if (free_list == null_node)
+		{
+			nodes.push_back(node {});
+			free_list = static_cast<int32_t>(nodes.size() - 1);
+			nodes[free_list].parent = null_node;
+		}
+
+		int32_t index = free_list;
+		free_list = nodes[index].parent;
+
+		nodes[index] = node {};
+		nodes[index].height = 0;
+
+		return index;
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::free_node(int32_t index)
+	{
+		nodes[index].parent = free_list;
+		nodes[index].body = nullptr;
+		nodes[index].height = -1;
+		free_list = index;
+	}
+
+	template <typename real>
+	physics::basic_aabb<real> basic_dynamic_tree<real>::get_fat_aabb(const physics::basic_body<real>* body) const
+	{
+		physics::basic_aabb<real> aabb = body->get_aabb();
+
+		real margin = margin_ratio * std::max(aabb.max.x - aabb.min.x, aabb.max.y - aabb.min.y);
+
+		aabb.min = { aabb.min.x - margin, aabb.min.y - margin };
+		aabb.max = { aabb.max.x + margin, aabb.max.y + margin };
+
+		return aabb;
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::insert_leaf(int32_t leaf)
+	{
+		if (root == null_node)
+		{
+			root = leaf;
+			nodes[root].parent = null_node;
+			return;
+		}
+
+		// Find the best sibling by descending the tree using the surface area heuristic (perimeter in 2D)
+		physics::basic_aabb<real> leaf_aabb = nodes[leaf].aabb;
+		int32_t index = root;
+
+		while (!nodes[index].is_leaf())
+		{
+			int32_t child_a = nodes[index].child_a;
+			int32_t child_b = nodes[index].child_b;
+
+			real perimeter = aabb_perimeter(nodes[index].aabb);
+			real combined_perimeter = aabb_perimeter(aabb_union(nodes[index].aabb, leaf_aabb));
+
+			// Cost of creating a new parent for this node and the new leaf
+			real cost = 2 * combined_perimeter;
+
+			// Minimum cost of pushing the leaf further down the tree
+			real inheritance_cost = 2 * (combined_perimeter - perimeter);
+
+			auto descend_cost = [&](int32_t child)
+			{
+				real child_cost = aabb_perimeter(aabb_union(leaf_aabb, nodes[child].aabb));
+
+				if (!nodes[child].is_leaf())
+					child_cost -= aabb_perimeter(nodes[child].aabb);
+
+				return child_cost + inheritance_cost;
+			};
+
+			real cost_a = descend_cost(child_a);
+			real cost_b = descend_cost(child_b);
+
+			if (cost < cost_a && cost < cost_b)
+				break;
+
+			index = cost_a < cost_b ? child_a : child_b;
+		}
+
+		int32_t sibling = index;
+
+		// Create a new parent for the sibling and the leaf
+		int32_t old_parent = nodes[sibling].parent;
+		int32_t new_parent = allocate_node();
+
+		nodes[new_parent].parent = old_parent;
+		nodes[new_parent].aabb = aabb_union(leaf_aabb, nodes[sibling].aabb);
+		nodes[new_parent].height = nodes[sibling].height + 1;
+		nodes[new_parent].child_a = sibling;
+		nodes[new_parent].child_b = leaf;
+
+		nodes[sibling].parent = new_parent;
+		nodes[leaf].parent = new_parent;
+
+		if (old_parent == null_node)
+		{
+			root = new_parent;
+		}
+		else if (nodes[old_parent].child_a == sibling)
+		{
+			nodes[old_parent].child_a = new_parent;
+		}
+		else
+		{
+			nodes[old_parent].child_b = new_parent;
+		}
+
+		refit(nodes[leaf].parent);
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::remove_leaf(int32_t leaf)
+	{
+		if (leaf == root)
+		{
+			root = null_node;
+			return;
+		}
+
+		int32_t parent = nodes[leaf].parent;
+		int32_t grand_parent = nodes[parent].parent;
+		int32_t sibling = nodes[parent].child_a == leaf ? nodes[parent].child_b : nodes[parent].child_a;
+
+		// Replace the parent with the sibling
+		if (grand_parent == null_node)
+		{
+			root = sibling;
+			nodes[sibling].parent = null_node;
+			free_node(parent);
+			return;
+		}
+
+		if (nodes[grand_parent].child_a == parent)
+			nodes[grand_parent].child_a = sibling;
+		else
+			nodes[grand_parent].child_b = sibling;
+
+		nodes[sibling].parent = grand_parent;
+		free_node(parent);
+
+		refit(grand_parent);
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::refit(int32_t index)
+	{
+		while (index != null_node)
+		{
+			index = balance(index);
+
+			int32_t child_a = nodes[index].child_a;
+			int32_t child_b = nodes[index].child_b;
+
+			nodes[index].height = 1 + std::max(nodes[child_a].height, nodes[child_b].height);
+			nodes[index].aabb = aabb_union(nodes[child_a].aabb, nodes[child_b].aabb);
+
+			index = nodes[index].parent;
+		}
+	}
+
+	template <typename real>
+	int32_t basic_dynamic_tree<real>::balance(int32_t index_a)
+	{
+		// A is the node being balanced, with children B and C
+		// If one child is taller by more than one level, it is rotated up to replace A
+		node& a = nodes[index_a];
+
+		if (a.is_leaf() || a.height < 2)
+			return index_a;
+
+		int32_t index_b = a.child_a;
+		int32_t index_c = a.child_b;
+
+		int32_t height_difference = nodes[index_c].height - nodes[index_b].height;
+
+		// Rotate C up if the right subtree is too tall (or B up if the left subtree is too tall)
+		if (height_difference > 1 || height_difference < -1)
+		{
+			bool rotate_c = height_difference > 1;
+
+			int32_t index_up = rotate_c ? index_c : index_b;
+			int32_t index_other = rotate_c ? index_b : index_c;
+
+			node& up = nodes[index_up];
+			int32_t index_f = up.child_a;
+			int32_t index_g = up.child_b;
+
+			// Swap A and the raised node
+			up.child_a = index_a;
+			up.parent = a.parent;
+			a.parent = index_up;
+
+			if (up.parent == null_node)
+			{
+				root = index_up;
+			}
+			else if (nodes[up.parent].child_a == index_a)
+			{
+				nodes[up.parent].child_a = index_up;
+			}
+			else
+			{
+				nodes[up.parent].child_b = index_up;
+			}
+
+			// Keep the taller grandchild under the raised node, and move the shorter one under A
+			int32_t index_keep = nodes[index_f].height > nodes[index_g].height ? index_f : index_g;
+			int32_t index_move = index_keep == index_f ? index_g : index_f;
+
+			up.child_b = index_keep;
+
+			if (rotate_c)
+				a.child_b = index_move;
+			else
+				a.child_a = index_move;
+
+			nodes[index_move].parent = index_a;
+
+			a.aabb = aabb_union(nodes[index_other].aabb, nodes[index_move].aabb);
+			a.height = 1 + std::max(nodes[index_other].height, nodes[index_move].height);
+
+			up.aabb = aabb_union(a.aabb, nodes[index_keep].aabb);
+			up.height = 1 + std::max(a.height, nodes[index_keep].height);
+
+			return index_up;
+		}
+
+		return index_a;
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::insert(physics::basic_body<real>* body)
+	{
+		int32_t leaf = allocate_node();
+		nodes[leaf].body = body;
+		nodes[leaf].aabb = get_fat_aabb(body);
+
+		leaf_lookup[body->get_id()] = leaf;
+		insert_leaf(leaf);
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::remove(physics::basic_body<real>* body)
+	{
+		auto it = leaf_lookup.find(body->get_id());
+		if (it == leaf_lookup.end())
+			return;
+
+		int32_t leaf = it->second;
+		leaf_lookup.erase(it);
+
+		remove_leaf(leaf);
+		free_node(leaf);
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::clear()
+	{
+		nodes.clear();
+		leaf_lookup.clear();
+		root = null_node;
+		free_list = null_node;
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::update()
+	{
+		for (const auto& [id, leaf] : leaf_lookup)
+		{
+			physics::basic_body<real>* body = nodes[leaf].body;
+
+			// Bodies that stay within their fattened AABB keep their place in the tree
+			if (aabb_contains(nodes[leaf].aabb, body->get_aabb()))
+				continue;
+
+			remove_leaf(leaf);
+			nodes[leaf].aabb = get_fat_aabb(body);
+			insert_leaf(leaf);
+		}
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::find_pairs(std::vector<physics::basic_body_pair<real>>& pairs)
+	{
+		if (root == null_node)
+			return;
+
+		// Traverse the tree against itself
+		// Every internal node tests its two subtrees against each other
+		self_stack.clear();
+		self_stack.push_back(root);
+
+		while (!self_stack.empty())
+		{
+			int32_t index = self_stack.back();
+			self_stack.pop_back();
+
+			const node& self = nodes[index];
+			if (self.is_leaf())
+				continue;
+
+			self_stack.push_back(self.child_a);
+			self_stack.push_back(self.child_b);
+
+			pair_stack.clear();
+			pair_stack.push_back({ self.child_a, self.child_b });
+
+			while (!pair_stack.empty())
+			{
+				auto [index_a, index_b] = pair_stack.back();
+				pair_stack.pop_back();
+
+				const node& node_a = nodes[index_a];
+				const node& node_b = nodes[index_b];
+
+				if (!aabb_intersection(node_a.aabb, node_b.aabb))
+					continue;
+
+				if (node_a.is_leaf() && node_b.is_leaf())
+				{
+					physics::basic_body<real>* body_a = node_a.body;
+					physics::basic_body<real>* body_b = node_b.body;
+
+					if (body_a->get_type() == physics::static_body && body_b->get_type() == physics::static_body)
+						continue;
+
+					// Fat AABBs overlap, test the actual AABBs
+					if (!aabb_intersection(body_a->get_aabb(), body_b->get_aabb()))
+						continue;
+
+					pairs.push_back(make_body_pair(body_a, body_b));
+				}
+				else if (node_b.is_leaf() || (!node_a.is_leaf() && node_a.height >= node_b.height))
+				{
+					// Descend into the taller subtree
+					pair_stack.push_back({ node_a.child_a, index_b });
+					pair_stack.push_back({ node_a.child_b, index_b });
+				}
+				else
+				{
+					pair_stack.push_back({ index_a, node_b.child_a });
+					pair_stack.push_back({ index_a, node_b.child_b });
+				}
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_dynamic_tree<real>::query(const physics::basic_aabb<real>& aabb, std::vector<physics::basic_body<real>*>& results)
+	{
+		if (root == null_node)
+			return;
+
+		query_stack.clear();
+		query_stack.push_back(root);
+
+		while (!query_stack.empty())
+		{
+			int32_t index = query_stack.back();
+			query_stack.pop_back();
+
+			const node& node = nodes[index];
+
+			if (!aabb_intersection(node.aabb, aabb))
+				continue;
+
+			if (node.is_leaf())
+			{
+				if (aabb_intersection(node.body->get_aabb(), aabb))
+					results.push_back(node.body);
+			}
+			else
+			{
+				query_stack.push_back(node.child_a);
+				query_stack.push_back(node.child_b);
+			}
+		}
+	}
+
+	template <typename real>
+	int32_t basic_dynamic_tree<real>::get_height() const
+	{
+		if (root == null_node)
+			return 0;
+
+		return nodes[root].height;
+	}
+
+	template class basic_dynamic_tree<float>;
+	template class basic_dynamic_tree<double>;
+}
\ No newline at end of file
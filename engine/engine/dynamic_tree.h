@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include "broad_phase.h"
+
+namespace physics
+{
+	// Dynamic AABB tree broad phase (bounding volume hierarchy)
+	// Each body is a leaf with a fattened AABB, so bodies that move within their margin are not reinserted
+	// The tree is kept balanced with rotations and pairs are found by traversing the tree against itself
+	template <typename real>
+	class basic_dynamic_tree : public basic_broad_phase<real>
+	{
+	private:
+		static constexpr int32_t null_node = -1;
+
+		struct node
+		{
+			// Fattened AABB for leaves, union of children for internal nodes
+			physics::basic_aabb<real> aabb {};
+
+			// Body stored in a leaf (nullptr for internal nodes)
+			physics::basic_body<real>* body { nullptr };
+
+			// Parent node, or next free node when the node is not in use
+			int32_t parent { null_node };
+
+			int32_t child_a { null_node };
+			int32_t child_b { null_node };
+
+			// Leaves have height 0, free nodes have height -1
+			int32_t height { -1 };
+
+			bool is_leaf() const;
+		};
+
+		std::vector<node> nodes {};
+		int32_t root { null_node };
+		int32_t free_list { null_node };
+
+		// Body id -> leaf node
+		std::unordered_map<size_t, int32_t> leaf_lookup {};
+
+		// Fraction of the body's size each leaf AABB is expanded by
+		real margin_ratio { real(0.1) };
+
+		// Traversal stacks (kept between steps to avoid allocations)
+		std::vector<int32_t> self_stack {};
+		std::vector<std::pair<int32_t, int32_t>> pair_stack {};
+		std::vector<int32_t> query_stack {};
+
+		int32_t allocate_node();
+		void free_node(int32_t index);
+
+		physics::basic_aabb<real> get_fat_aabb(const physics::basic_body<real>* body) const;
+
+		void insert_leaf(int32_t leaf);
+		void remove_leaf(int32_t leaf);
+
+		// Walks up the tree from a node, rebalancing and refitting each ancestor
+		void refit(int32_t index);
+
+		// Performs a left or right rotation if a node is imbalanced
+		// Returns the index of the new subtree root
+		int32_t balance(int32_t index);
+
+	public:
+		basic_dynamic_tree() = default;
+		basic_dynamic_tree(real margin_ratio);
+
+		void insert(physics::basic_body<real>* body) override;
+		void remove(physics::basic_body<real>* body) override;
+		void clear() override;
+		void update() override;
+		void find_pairs(std::vector<physics::basic_body_pair<real>>& pairs) override;
+
+		// Find all bodies in the tree whose AABB overlaps the given AABB
+		void query(const physics::basic_aabb<real>& aabb, std::vector<physics::basic_body<real>*>& results);
+
+		// Get the height of the tree (0 for a single leaf)
+		int32_t get_height() const;
+	};
+
+	using dynamic_tree = basic_dynamic_tree<double>;
+}
\ No newline at end of file
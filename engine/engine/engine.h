@@ -2,9 +2,23 @@
 
 #include "aabb.h"
 #include "body.h"
+#include "body_storage.h"
+#include "broad_phase.h"
 #include "collision.h"
+#include "contact_cache.h"
+#include "contact_solver.h"
+#include "dynamic_tree.h"
+#include "force_generator.h"
+#include "gjk.h"
+#include "integrator.h"
+#include "island.h"
 #include "material.h"
 #include "math.h"
+#include "n_body.h"
 #include "shape.h"
+#include "sweep_and_prune.h"
+#include "thread_pool.h"
 #include "timer.h"
+#include "uniform_grid.h"
+#include "vertex_array.h"
 #include "world.h"
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "force_generator.h"
+#include "body.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace physics
+{
+	template <typename real>
+	template <typename force_type>
+	size_t basic_force_generator_set<real>::add(generator_list<force_type>& list, const force_type& force)
+	{
+		list.ids.push_back(next_id);
+		list.forces.push_back(force);
+
+		return next_id++;
+	}
+
+	template <typename real>
+	template <typename force_type>
+	bool basic_force_generator_set<real>::remove(generator_list<force_type>& list, size_t id)
+	{
+		auto it = std::find(list.ids.begin(), list.ids.end(), id);
+		if (it == list.ids.end())
+			return false;
+
+		// Erased rather than swapped so the generators keep the order they were added in
+		size_t index = it - list.ids.begin();
+		list.ids.erase(it);
+		list.forces.erase(list.forces.begin() + index);
+
+		return true;
+	}
+
+	template <typename real>
+	size_t basic_force_generator_set<real>::add(const physics::basic_uniform_force<real>& force)
+	{
+		return add(uniform_forces, force);
+	}
+
+	template <typename real>
+	size_t basic_force_generator_set<real>::add(const physics::basic_point_attractor<real>& force)
+	{
+		return add(attractors, force);
+	}
+
+	template <typename real>
+	size_t basic_force_generator_set<real>::add(const physics::basic_drag_force<real>& force)
+	{
+		return add(drag_forces, force);
+	}
+
+	template <typename real>
+	size_t basic_force_generator_set<real>::add(const physics::basic_wind_force<real>& force)
+	{
+		return add(wind_forces, force);
+	}
+
+	template <typename real>
+	size_t basic_force_generator_set<real>::add(const physics::basic_anchor_spring<real>& force)
+	{
+		return add(springs, force);
+	}
+
+	template <typename real>
+	void basic_force_generator_set<real>::remove(size_t id)
+	{
+		remove(uniform_forces, id) || remove(attractors, id) || remove(drag_forces, id) || remove(wind_forces, id) || remove(springs, id);
+	}
+
+	template <typename real>
+	void basic_force_generator_set<real>::remove_body(const physics::basic_body<real>* body)
+	{
+		for (size_t i = springs.forces.size(); i-- > 0;)
+		{
+			if (springs.forces[i].body == body)
+				remove(springs, springs.ids[i]);
+		}
+	}
+
+	template <typename real>
+	void basic_force_generator_set<real>::clear()
+	{
+		uniform_forces = {};
+		attractors = {};
+		drag_forces = {};
+		wind_forces = {};
+		springs = {};
+	}
+
+	template <typename real>
+	bool basic_force_generator_set<real>::empty() const
+	{
+		return uniform_forces.ids.empty() && attractors.ids.empty() && drag_forces.ids.empty() && wind_forces.ids.empty() && springs.ids.empty();
+	}
+
+	template <typename real>
+	void basic_force_generator_set<real>::apply(physics::basic_body_storage<real>& storage, size_t begin, size_t end) const
+	{
+		real* force_x = storage.force_x.data();
+		real* force_y = storage.force_y.data();
+		const real* position_x = storage.position_x.data();
+		const real* position_y = storage.position_y.data();
+		const real* velocity_x = storage.velocity_x.data();
+		const real* velocity_y = storage.velocity_y.data();
+		const real* inv_mass = storage.inv_mass.data();
+
+		// Uniform accelerations are summed, so they cost one pass however many there are
+		if (!uniform_forces.forces.empty())
+		{
+			physics::vec_2<real> acceleration {};
+			for (const physics::basic_uniform_force<real>& force : uniform_forces.forces)
+				acceleration = vec_add(acceleration, force.acceleration);
+
+			for (size_t i = begin; i < end; i++)
+			{
+				real mass = inv_mass[i] > 0 ? 1 / inv_mass[i] : 0;
+
+				force_x[i] += acceleration.x * mass;
+				force_y[i] += acceleration.y * mass;
+			}
+		}
+
+		for (const physics::basic_point_attractor<real>& attractor : attractors.forces)
+		{
+			real min_distance_sq = attractor.min_distance * attractor.min_distance;
+			real radius_sq = attractor.radius > 0 ? attractor.radius * attractor.radius : std::numeric_limits<real>::max();
+
+			for (size_t i = begin; i < end; i++)
+			{
+				real offset_x = attractor.position.x - position_x[i];
+				real offset_y = attractor.position.y - position_y[i];
+				real distance_sq = offset_x * offset_x + offset_y * offset_y;
+
+				if (inv_mass[i] == 0 || distance_sq > radius_sq || distance_sq == 0)
+					continue;
+
+				// Direction divided by the clamped squared distance
+				real factor = attractor.strength / (std::sqrt(distance_sq) * std::max(distance_sq, min_distance_sq) * inv_mass[i]);
+
+				force_x[i] += offset_x * factor;
+				force_y[i] += offset_y * factor;
+			}
+		}
+
+		for (const physics::basic_drag_force<real>& drag : drag_forces.forces)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				real speed = std::sqrt(velocity_x[i] * velocity_x[i] + velocity_y[i] * velocity_y[i]);
+				real factor = drag.linear + drag.quadratic * speed;
+
+				force_x[i] -= velocity_x[i] * factor;
+				force_y[i] -= velocity_y[i] * factor;
+			}
+		}
+
+		for (const physics::basic_wind_force<real>& wind : wind_forces.forces)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				bool inside = position_x[i] >= wind.region.min.x && position_x[i] <= wind.region.max.x && position_y[i] >= wind.region.min.y && position_y[i] <= wind.region.max.y;
+				if (!inside)
+					continue;
+
+				force_x[i] += (wind.velocity.x - velocity_x[i]) * wind.coefficient;
+				force_y[i] += (wind.velocity.y - velocity_y[i]) * wind.coefficient;
+			}
+		}
+
+		// Springs act on single bodies, each is applied by the range holding its body
+		for (const physics::basic_anchor_spring<real>& spring : springs.forces)
+		{
+			size_t i = spring.body->index;
+			if (i < begin || i >= end)
+				continue;
+
+			real offset_x = spring.anchor.x - position_x[i];
+			real offset_y = spring.anchor.y - position_y[i];
+			real length = std::sqrt(offset_x * offset_x + offset_y * offset_y);
+
+			if (length == 0)
+				continue;
+
+			real direction_x = offset_x / length;
+			real direction_y = offset_y / length;
+
+			// Stretching pulls towards the anchor, motion along the spring is damped
+			real speed = velocity_x[i] * direction_x + velocity_y[i] * direction_y;
+			real magnitude = spring.stiffness * (length - spring.rest_length) - spring.damping * speed;
+
+			force_x[i] += direction_x * magnitude;
+			force_y[i] += direction_y * magnitude;
+		}
+	}
+
+	template class basic_force_generator_set<float>;
+	template class basic_force_generator_set<double>;
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <limits>
+#include <cstdint>
+#include <vector>
+#include "aabb.h"
+#include "body_storage.h"
+
+namespace physics
+{
+	// Acceleration applied to every body, like the world's gravity
+	template <typename real>
+	struct basic_uniform_force
+	{
+		physics::vec_2<real> acceleration {};
+	};
+
+	// Pulls bodies towards a point with an acceleration that falls off with the square of the distance
+	template <typename real>
+	struct basic_point_attractor
+	{
+		physics::vec_2<real> position {};
+
+		// Acceleration at a distance of 1 (negative to repel)
+		real strength { 0 };
+
+		// Closer bodies are pulled as if they were this far away, so the acceleration stays finite
+		real min_distance { 1 };
+
+		// Bodies further away than this are not pulled (0 for no limit)
+		real radius { 0 };
+	};
+
+	// Slows bodies down with a force of -(linear + quadratic * speed) * velocity
+	template <typename real>
+	struct basic_drag_force
+	{
+		real linear { 0 };
+		real quadratic { 0 };
+	};
+
+	// Pushes bodies inside a region towards the velocity of the wind with a force of coefficient * (wind velocity - body velocity)
+	template <typename real>
+	struct basic_wind_force
+	{
+		physics::vec_2<real> velocity {};
+		real coefficient { 0 };
+
+		// Only bodies whose position is inside the region are pushed
+		physics::basic_aabb<real> region { { -std::numeric_limits<real>::max(), -std::numeric_limits<real>::max() }, { std::numeric_limits<real>::max(), std::numeric_limits<real>::max() } };
+	};
+
+	// Damped spring from the center of a body to a fixed point in world space
+	template <typename real>
+	struct basic_anchor_spring
+	{
+		physics::basic_body<real>* body { nullptr };
+		physics::vec_2<real> anchor {};
+
+		real rest_length { 0 };
+		real stiffness { 0 };
+
+		// Force per unit of velocity along the spring opposing the body's motion
+		real damping { 0 };
+	};
+
+	// Force generators added to a world, evaluated in bulk over ranges of storage slots before integration
+	// Each generator is identified by the id returned when it is added
+	template <typename real>
+	class basic_force_generator_set
+	{
+	private:
+		template <typename force_type>
+		struct generator_list
+		{
+			std::vector<size_t> ids {};
+			std::vector<force_type> forces {};
+		};
+
+		generator_list<physics::basic_uniform_force<real>> uniform_forces {};
+		generator_list<physics::basic_point_attractor<real>> attractors {};
+		generator_list<physics::basic_drag_force<real>> drag_forces {};
+		generator_list<physics::basic_wind_force<real>> wind_forces {};
+		generator_list<physics::basic_anchor_spring<real>> springs {};
+
+		size_t next_id { 1 };
+
+		template <typename force_type>
+		size_t add(generator_list<force_type>& list, const force_type& force);
+
+		template <typename force_type>
+		bool remove(generator_list<force_type>& list, size_t id);
+
+	public:
+		size_t add(const physics::basic_uniform_force<real>& force);
+		size_t add(const physics::basic_point_attractor<real>& force);
+		size_t add(const physics::basic_drag_force<real>& force);
+		size_t add(const physics::basic_wind_force<real>& force);
+		size_t add(const physics::basic_anchor_spring<real>& force);
+
+		// Removes the generator with the given id
+		void remove(size_t id);
+
+		// Removes the springs attached to a body
+		void remove_body(const physics::basic_body<real>* body);
+
+		void clear();
+		bool empty() const;
+
+		// Adds the force of every generator to the bodies in storage slots [begin, end)
+		// Each generator is applied to the whole range at once, and only the forces of the range are written
+		void apply(physics::basic_body_storage<real>& storage, size_t begin, size_t end) const;
+	};
+
+	using uniform_force = basic_uniform_force<double>;
+	using point_attractor = basic_point_attractor<double>;
+	using drag_force = basic_drag_force<double>;
+	using wind_force = basic_wind_force<double>;
+	using anchor_spring = basic_anchor_spring<double>;
+	using force_generator_set = basic_force_generator_set<double>;
+}
\ No newline at end of file
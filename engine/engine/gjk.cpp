@@ -0,0 +1,601 @@
+#include "gjk.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace physics
+{
+	// GJK stops as soon as it finds a support point it already has, this only bounds degenerate cases
+	const size_t gjk_max_iterations = 32;
+
+	// Squared length below which the closest point is treated as the origin
+	// Tolerances are larger in float, which only keeps about 7 significant digits
+	template <typename real> constexpr real gjk_epsilon_sq = real(1e-20);
+	template <> constexpr float gjk_epsilon_sq<float> = 1e-12f;
+
+	// EPA polygons are stored inline, so finding the penetration never allocates
+	const size_t epa_max_vertices = 32;
+
+	// EPA stops once a new support point improves the penetration by less than this
+	template <typename real> constexpr real epa_tolerance = real(1e-9);
+	template <> constexpr float epa_tolerance<float> = 1e-5f;
+
+	// Edges within about 2.5 degrees of perpendicular to the normal touch along their length and get two contact points
+	template <typename real> constexpr real contact_edge_alignment = real(0.999);
+
+	// Vertex of the Minkowski difference of the shapes (b - a) and the vertices it was made from
+	template <typename real>
+	struct simplex_vertex
+	{
+		physics::vec_2<real> point_a {};
+		physics::vec_2<real> point_b {};
+		physics::vec_2<real> point {};
+
+		size_t index_a { 0 };
+		size_t index_b { 0 };
+
+		// Barycentric weight of the vertex in the point of the simplex closest to the origin
+		real weight { 1 };
+	};
+
+	template <typename real>
+	struct simplex
+	{
+		physics::simplex_vertex<real> vertices[3] {};
+		size_t count { 0 };
+	};
+
+	// Index of the vertex furthest along a direction
+	template <typename real>
+	size_t get_support_index(const physics::basic_shape_view<real>& shape, physics::vec_2<real> direction)
+	{
+		size_t support_index = 0;
+		real support_distance = -std::numeric_limits<real>::max();
+
+		for (size_t i = 0; i < shape.vertices.size(); i++)
+		{
+			real distance = vec_dot(shape.vertices[i], direction);
+
+			if (distance > support_distance)
+			{
+				support_distance = distance;
+				support_index = i;
+			}
+		}
+
+		return support_index;
+	}
+
+	// Circles have their center as their only vertex
+	template <typename real>
+	physics::vec_2<real> get_vertex(const physics::basic_shape_view<real>& shape, size_t index)
+	{
+		return shape.vertices.empty() ? shape.origin : shape.vertices[index];
+	}
+
+	// Point of the Minkowski difference furthest along a direction
+	template <typename real>
+	physics::simplex_vertex<real> get_support(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::vec_2<real> direction)
+	{
+		physics::simplex_vertex<real> vertex {};
+		vertex.index_a = get_support_index(shape_a, vec_mul(direction, -1));
+		vertex.index_b = get_support_index(shape_b, direction);
+		vertex.point_a = get_vertex(shape_a, vertex.index_a);
+		vertex.point_b = get_vertex(shape_b, vertex.index_b);
+		vertex.point = vec_sub(vertex.point_b, vertex.point_a);
+
+		return vertex;
+	}
+
+	// Finds the point of a segment closest to the origin, vertices that don't contribute are removed
+	// https://box2d.org/files/ErinCatto_GJK_GDC2010.pdf
+	template <typename real>
+	void solve_segment(physics::simplex<real>& simplex)
+	{
+		physics::simplex_vertex<real>& v1 = simplex.vertices[0];
+		physics::simplex_vertex<real>& v2 = simplex.vertices[1];
+
+		physics::vec_2<real> e12 = vec_sub(v2.point, v1.point);
+
+		// Origin is behind v1
+		real d12_2 = -vec_dot(v1.point, e12);
+		if (d12_2 <= 0)
+		{
+			v1.weight = 1;
+			simplex.count = 1;
+			return;
+		}
+
+		// Origin is past v2
+		real d12_1 = vec_dot(v2.point, e12);
+		if (d12_1 <= 0)
+		{
+			v2.weight = 1;
+			v1 = v2;
+			simplex.count = 1;
+			return;
+		}
+
+		real inv_d12 = 1 / (d12_1 + d12_2);
+		v1.weight = d12_1 * inv_d12;
+		v2.weight = d12_2 * inv_d12;
+		simplex.count = 2;
+	}
+
+	// Finds the point of a triangle closest to the origin, vertices that don't contribute are removed
+	template <typename real>
+	void solve_triangle(physics::simplex<real>& simplex)
+	{
+		physics::simplex_vertex<real>& v1 = simplex.vertices[0];
+		physics::simplex_vertex<real>& v2 = simplex.vertices[1];
+		physics::simplex_vertex<real>& v3 = simplex.vertices[2];
+
+		physics::vec_2<real> w1 = v1.point;
+		physics::vec_2<real> w2 = v2.point;
+		physics::vec_2<real> w3 = v3.point;
+
+		// Barycentric coordinates of the origin on each edge
+		physics::vec_2<real> e12 = vec_sub(w2, w1);
+		real d12_1 = vec_dot(w2, e12);
+		real d12_2 = -vec_dot(w1, e12);
+
+		physics::vec_2<real> e13 = vec_sub(w3, w1);
+		real d13_1 = vec_dot(w3, e13);
+		real d13_2 = -vec_dot(w1, e13);
+
+		physics::vec_2<real> e23 = vec_sub(w3, w2);
+		real d23_1 = vec_dot(w3, e23);
+		real d23_2 = -vec_dot(w2, e23);
+
+		// Barycentric coordinates of the origin in the triangle
+		real n123 = vec_cross(e12, e13);
+		real d123_1 = n123 * vec_cross(w2, w3);
+		real d123_2 = n123 * vec_cross(w3, w1);
+		real d123_3 = n123 * vec_cross(w1, w2);
+
+		if (d12_2 <= 0 && d13_2 <= 0)
+		{
+			v1.weight = 1;
+			simplex.count = 1;
+		}
+		else if (d12_1 > 0 && d12_2 > 0 && d123_3 <= 0)
+		{
+			real inv_d12 = 1 / (d12_1 + d12_2);
+			v1.weight = d12_1 * inv_d12;
+			v2.weight = d12_2 * inv_d12;
+			simplex.count = 2;
+		}
+		else if (d13_1 > 0 && d13_2 > 0 && d123_2 <= 0)
+		{
+			real inv_d13 = 1 / (d13_1 + d13_2);
+			v1.weight = d13_1 * inv_d13;
+			v3.weight = d13_2 * inv_d13;
+			v2 = v3;
+			simplex.count = 2;
+		}
+		else if (d12_1 <= 0 && d23_2 <= 0)
+		{
+			v2.weight = 1;
+			v1 = v2;
+			simplex.count = 1;
+		}
+		else if (d13_1 <= 0 && d23_1 <= 0)
+		{
+			v3.weight = 1;
+			v1 = v3;
+			simplex.count = 1;
+		}
+		else if (d23_1 > 0 && d23_2 > 0 && d123_1 <= 0)
+		{
+			real inv_d23 = 1 / (d23_1 + d23_2);
+			v2.weight = d23_1 * inv_d23;
+			v3.weight = d23_2 * inv_d23;
+			v1 = v3;
+			simplex.count = 2;
+		}
+		else
+		{
+			// The origin is inside the triangle
+			real inv_d123 = 1 / (d123_1 + d123_2 + d123_3);
+			v1.weight = d123_1 * inv_d123;
+			v2.weight = d123_2 * inv_d123;
+			v3.weight = d123_3 * inv_d123;
+			simplex.count = 3;
+		}
+	}
+
+	// Direction from the simplex towards the origin
+	template <typename real>
+	physics::vec_2<real> get_search_direction(const physics::simplex<real>& simplex)
+	{
+		if (simplex.count == 1)
+			return vec_mul(simplex.vertices[0].point, -1);
+
+		physics::vec_2<real> e12 = vec_sub(simplex.vertices[1].point, simplex.vertices[0].point);
+
+		// Perpendicular of the segment on the side of the origin
+		if (vec_cross(e12, vec_mul(simplex.vertices[0].point, -1)) > 0)
+			return { -e12.y, e12.x };
+
+		return { e12.y, -e12.x };
+	}
+
+	// Runs GJK on the vertex hulls of two shapes, radii are ignored
+	// The final simplex is left for EPA if the hulls overlap
+	template <typename real>
+	physics::basic_distance_result<real> get_hull_distance(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::simplex<real>& simplex)
+	{
+		physics::basic_distance_result<real> result {};
+
+		physics::vec_2<real> direction = vec_sub(shape_b.origin, shape_a.origin);
+		if (vec_magnitude_sq(direction) == 0)
+			direction = { 1, 0 };
+
+		simplex.vertices[0] = get_support(shape_a, shape_b, direction);
+		simplex.count = 1;
+		result.iterations = 1;
+
+		while (result.iterations < physics::gjk_max_iterations)
+		{
+			// Vertices of the last simplex, a repeated support point means no further progress is possible
+			size_t saved_count = simplex.count;
+			size_t saved_a[3] {};
+			size_t saved_b[3] {};
+
+			for (size_t i = 0; i < saved_count; i++)
+			{
+				saved_a[i] = simplex.vertices[i].index_a;
+				saved_b[i] = simplex.vertices[i].index_b;
+			}
+
+			if (simplex.count == 2)
+				solve_segment(simplex);
+			else if (simplex.count == 3)
+				solve_triangle(simplex);
+
+			// The origin is inside the simplex, so the hulls overlap
+			if (simplex.count == 3)
+				break;
+
+			direction = get_search_direction(simplex);
+
+			// The origin is on the simplex, so the hulls touch
+			if (vec_magnitude_sq(direction) < physics::gjk_epsilon_sq<real>)
+				break;
+
+			physics::simplex_vertex<real> vertex = get_support(shape_a, shape_b, direction);
+			result.iterations++;
+
+			bool duplicate = false;
+			for (size_t i = 0; i < saved_count; i++)
+			{
+				if (vertex.index_a == saved_a[i] && vertex.index_b == saved_b[i])
+				{
+					duplicate = true;
+					break;
+				}
+			}
+
+			if (duplicate)
+				break;
+
+			simplex.vertices[simplex.count] = vertex;
+			simplex.count++;
+		}
+
+		// Closest points are the weighted vertices of the simplex
+		for (size_t i = 0; i < simplex.count; i++)
+		{
+			result.point_a = vec_add(result.point_a, vec_mul(simplex.vertices[i].point_a, simplex.vertices[i].weight));
+			result.point_b = vec_add(result.point_b, vec_mul(simplex.vertices[i].point_b, simplex.vertices[i].weight));
+		}
+
+		if (simplex.count == 3)
+			result.point_b = result.point_a;
+
+		result.distance = get_distance(result.point_a, result.point_b);
+		result.overlap = simplex.count == 3 || result.distance * result.distance < physics::gjk_epsilon_sq<real>;
+
+		return result;
+	}
+
+	// Expands the final GJK simplex of two overlapping hulls with EPA until it finds the edge of the Minkowski difference closest to the origin
+	// Returns false if the Minkowski difference has no area (both hulls are points or parallel segments)
+	template <typename real>
+	bool get_hull_penetration(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, const physics::simplex<real>& simplex, physics::vec_2<real>& normal, real& depth, physics::vec_2<real>& point_a, physics::vec_2<real>& point_b)
+	{
+		physics::simplex_vertex<real> polygon[physics::epa_max_vertices] {};
+		size_t count = simplex.count;
+
+		for (size_t i = 0; i < count; i++)
+			polygon[i] = simplex.vertices[i];
+
+		// GJK stops at a point or segment if the hulls only touch, grow it into a triangle
+		if (count == 1)
+		{
+			const physics::vec_2<real> directions[] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+			for (physics::vec_2<real> direction : directions)
+			{
+				physics::simplex_vertex<real> vertex = get_support(shape_a, shape_b, direction);
+
+				if (get_distance_sq(vertex.point, polygon[0].point) > physics::gjk_epsilon_sq<real>)
+				{
+					polygon[count] = vertex;
+					count++;
+					break;
+				}
+			}
+		}
+
+		if (count == 2)
+		{
+			physics::vec_2<real> edge = vec_sub(polygon[1].point, polygon[0].point);
+
+			for (physics::vec_2<real> direction : { physics::vec_2<real> { -edge.y, edge.x }, physics::vec_2<real> { edge.y, -edge.x } })
+			{
+				physics::simplex_vertex<real> vertex = get_support(shape_a, shape_b, direction);
+
+				if (std::abs(vec_cross(edge, vec_sub(vertex.point, polygon[0].point))) > physics::gjk_epsilon_sq<real>)
+				{
+					polygon[count] = vertex;
+					count++;
+					break;
+				}
+			}
+		}
+
+		if (count < 3)
+			return false;
+
+		// Edges are walked counter-clockwise so their right hand normals point away from the origin
+		if (vec_cross(vec_sub(polygon[1].point, polygon[0].point), vec_sub(polygon[2].point, polygon[0].point)) < 0)
+			std::swap(polygon[1], polygon[2]);
+
+		size_t closest_edge = 0;
+		physics::vec_2<real> closest_normal {};
+		real closest_distance = 0;
+
+		while (true)
+		{
+			closest_distance = std::numeric_limits<real>::max();
+
+			for (size_t i = 0; i < count; i++)
+			{
+				physics::vec_2<real> edge = vec_sub(polygon[(i + 1) % count].point, polygon[i].point);
+				real length = vec_magnitude(edge);
+
+				if (length == 0)
+					continue;
+
+				physics::vec_2<real> edge_normal = { edge.y / length, -edge.x / length };
+				real distance = vec_dot(edge_normal, polygon[i].point);
+
+				if (distance < closest_distance)
+				{
+					closest_distance = distance;
+					closest_normal = edge_normal;
+					closest_edge = i;
+				}
+			}
+
+			if (count == physics::epa_max_vertices)
+				break;
+
+			physics::simplex_vertex<real> vertex = get_support(shape_a, shape_b, closest_normal);
+
+			// The closest edge is on the boundary of the Minkowski difference
+			if (vec_dot(vertex.point, closest_normal) - closest_distance < physics::epa_tolerance<real>)
+				break;
+
+			// Insert the support point between the vertices of the closest edge
+			for (size_t i = count; i > closest_edge + 1; i--)
+				polygon[i] = polygon[i - 1];
+
+			polygon[closest_edge + 1] = vertex;
+			count++;
+		}
+
+		// Moving shape b by the depth against the edge normal separates the hulls
+		normal = vec_mul(closest_normal, -1);
+		depth = closest_distance;
+
+		// Closest points from where the origin projects onto the closest edge
+		const physics::simplex_vertex<real>& v1 = polygon[closest_edge];
+		const physics::simplex_vertex<real>& v2 = polygon[(closest_edge + 1) % count];
+
+		physics::vec_2<real> edge = vec_sub(v2.point, v1.point);
+		real t = std::clamp(-vec_dot(v1.point, edge) / vec_dot(edge, edge), real(0), real(1));
+
+		point_a = vec_add(v1.point_a, vec_mul(vec_sub(v2.point_a, v1.point_a), t));
+		point_b = vec_add(v1.point_b, vec_mul(vec_sub(v2.point_b, v1.point_b), t));
+
+		return true;
+	}
+
+	// Finds the edge at the vertex furthest along a direction that is closest to perpendicular to it
+	// Returns false if neither edge is close enough to perpendicular, only the vertex touches then
+	template <typename real>
+	bool get_contact_edge(const physics::basic_shape_view<real>& shape, physics::vec_2<real> direction, size_t& edge)
+	{
+		size_t n_vertices = shape.vertices.size();
+
+		if (n_vertices < 2 || shape.normals.size() != n_vertices)
+			return false;
+
+		size_t vertex = get_support_index(shape, direction);
+		size_t previous = (vertex + n_vertices - 1) % n_vertices;
+
+		// Normals may point either way depending on the winding
+		real previous_alignment = std::abs(vec_dot(shape.normals[previous], direction));
+		real next_alignment = std::abs(vec_dot(shape.normals[vertex], direction));
+
+		edge = previous_alignment > next_alignment ? previous : vertex;
+
+		return std::max(previous_alignment, next_alignment) >= physics::contact_edge_alignment<real>;
+	}
+
+	// Adds the contact points of two colliding shapes
+	// Two edges facing each other touch along their overlap, otherwise the shapes touch between their closest points
+	template <typename real>
+	void add_contact_points(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::vec_2<real> point_a, physics::vec_2<real> point_b, physics::basic_collision_manifold<real>& collision)
+	{
+		physics::vec_2<real> normal = collision.normal;
+		real radius = shape_a.radius + shape_b.radius;
+
+		size_t edge_a = 0;
+		size_t edge_b = 0;
+
+		if (get_contact_edge(shape_a, normal, edge_a) && get_contact_edge(shape_b, vec_mul(normal, -1), edge_b))
+		{
+			size_t n_vertices_a = shape_a.vertices.size();
+			size_t n_vertices_b = shape_b.vertices.size();
+
+			physics::vec_2<real> reference = shape_a.vertices[edge_a];
+			physics::vec_2<real> tangent = { -normal.y, normal.x };
+
+			// Extent of the edge of a along the tangent
+			size_t lower_vertex = edge_a;
+			size_t upper_vertex = (edge_a + 1) % n_vertices_a;
+			real lower = vec_dot(shape_a.vertices[lower_vertex], tangent);
+			real upper = vec_dot(shape_a.vertices[upper_vertex], tangent);
+
+			if (lower > upper)
+			{
+				std::swap(lower, upper);
+				std::swap(lower_vertex, upper_vertex);
+			}
+
+			// Edge of b, clipped to the extent of the edge of a
+			const physics::vec_2<real> incident_a = shape_b.vertices[edge_b];
+			const physics::vec_2<real> incident_b = shape_b.vertices[(edge_b + 1) % n_vertices_b];
+			real extent_a = vec_dot(incident_a, tangent);
+			real extent_b = vec_dot(incident_b, tangent);
+
+			if (extent_a != extent_b && std::max(extent_a, extent_b) >= lower && std::min(extent_a, extent_b) <= upper)
+			{
+				physics::vec_2<real> points[2] = { incident_a, incident_b };
+				real extents[2] = { extent_a, extent_b };
+				uint32_t feature_ids[2] = { make_feature_id(true, edge_b, edge_a), make_feature_id(true, (edge_b + 1) % n_vertices_b, edge_a) };
+
+				for (size_t i = 0; i < 2; i++)
+				{
+					real bound = extents[i] < lower ? lower : extents[i] > upper ? upper : extents[i];
+
+					if (bound != extents[i])
+					{
+						points[i] = vec_add(incident_a, vec_mul(vec_sub(incident_b, incident_a), (bound - extent_a) / (extent_b - extent_a)));
+						feature_ids[i] = make_feature_id(false, bound == lower ? lower_vertex : upper_vertex, edge_b);
+					}
+
+					// Points of b that are separated from the edge of a don't touch
+					real separation = vec_dot(vec_sub(points[i], reference), normal);
+					real point_depth = radius - separation;
+
+					if (point_depth >= 0)
+						collision.add_point(vec_add(points[i], vec_mul(normal, (shape_a.radius - shape_b.radius - separation) / 2)), point_depth, feature_ids[i]);
+				}
+
+				if (collision.point_count > 0)
+					return;
+			}
+		}
+
+		// Halfway between the surfaces of the shapes
+		physics::vec_2<real> surface_a = vec_add(point_a, vec_mul(normal, shape_a.radius));
+		physics::vec_2<real> surface_b = vec_sub(point_b, vec_mul(normal, shape_b.radius));
+		physics::vec_2<real> contact_point = vec_mul(vec_add(surface_a, surface_b), real(0.5));
+
+		size_t vertex_a = get_support_index(shape_a, normal);
+		size_t vertex_b = get_support_index(shape_b, vec_mul(normal, -1));
+
+		collision.add_point(contact_point, collision.depth, make_feature_id(false, vertex_a, vertex_b));
+	}
+
+	template <typename real>
+	physics::basic_distance_result<real> get_distance(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b)
+	{
+		physics::simplex<real> simplex {};
+		physics::basic_distance_result<real> hull_result = get_hull_distance(shape_a, shape_b, simplex);
+
+		physics::basic_distance_result<real> result {};
+		result.iterations = hull_result.iterations;
+		result.point_a = hull_result.point_a;
+		result.point_b = hull_result.point_b;
+
+		if (hull_result.distance > 0)
+			result.normal = vec_div(vec_sub(hull_result.point_b, hull_result.point_a), hull_result.distance);
+
+		real radius = shape_a.radius + shape_b.radius;
+
+		if (hull_result.overlap || hull_result.distance <= radius)
+		{
+			result.overlap = true;
+			return result;
+		}
+
+		// Move the closest points of the hulls out to the surfaces
+		result.distance = hull_result.distance - radius;
+		result.point_a = vec_add(hull_result.point_a, vec_mul(result.normal, shape_a.radius));
+		result.point_b = vec_sub(hull_result.point_b, vec_mul(result.normal, shape_b.radius));
+
+		return result;
+	}
+
+	template <typename real>
+	physics::basic_distance_result<real> get_distance(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b)
+	{
+		return get_distance(get_shape_view(body_a), get_shape_view(body_b));
+	}
+
+	template <typename real>
+	bool get_gjk_collision(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::basic_collision_manifold<real>& collision)
+	{
+		physics::simplex<real> simplex {};
+		physics::basic_distance_result<real> hull_result = get_hull_distance(shape_a, shape_b, simplex);
+
+		real radius = shape_a.radius + shape_b.radius;
+
+		physics::vec_2<real> normal {};
+		real depth = 0;
+		physics::vec_2<real> point_a = hull_result.point_a;
+		physics::vec_2<real> point_b = hull_result.point_b;
+
+		if (!hull_result.overlap)
+		{
+			// Separated hulls only collide through their radii
+			if (hull_result.distance > radius)
+				return false;
+
+			normal = vec_div(vec_sub(hull_result.point_b, hull_result.point_a), hull_result.distance);
+			depth = radius - hull_result.distance;
+		}
+		else if (get_hull_penetration(shape_a, shape_b, simplex, normal, depth, point_a, point_b))
+		{
+			depth += radius;
+		}
+		else
+		{
+			// Hulls without area (two points or parallel segments) are pushed apart along the line between the shapes
+			normal = vec_sub(shape_b.origin, shape_a.origin);
+			normal = vec_magnitude_sq(normal) > 0 ? vec_normalize(normal) : physics::vec_2<real> { 0, 1 };
+			depth = radius;
+		}
+
+		collision.normal = normal;
+		collision.depth = depth;
+
+		add_contact_points(shape_a, shape_b, point_a, point_b, collision);
+
+		return true;
+	}
+
+	template physics::basic_distance_result<float> get_distance<float>(const physics::basic_shape_view<float>&, const physics::basic_shape_view<float>&);
+	template physics::basic_distance_result<float> get_distance<float>(physics::basic_body<float>*, physics::basic_body<float>*);
+	template bool get_gjk_collision<float>(const physics::basic_shape_view<float>&, const physics::basic_shape_view<float>&, physics::basic_collision_manifold<float>&);
+
+	template physics::basic_distance_result<double> get_distance<double>(const physics::basic_shape_view<double>&, const physics::basic_shape_view<double>&);
+	template physics::basic_distance_result<double> get_distance<double>(physics::basic_body<double>*, physics::basic_body<double>*);
+	template bool get_gjk_collision<double>(const physics::basic_shape_view<double>&, const physics::basic_shape_view<double>&, physics::basic_collision_manifold<double>&);
+}
\ No newline at end of file
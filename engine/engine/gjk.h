@@ -0,0 +1,43 @@
+#pragma once
+
+#include "collision.h"
+
+namespace physics
+{
+	// Closest points between two shapes
+	template <typename real>
+	struct basic_distance_result
+	{
+		// True if the shapes overlap, the distance is then 0
+		bool overlap { false };
+
+		// Distance between the surfaces of the shapes
+		real distance { 0 };
+
+		// Closest points on the surface of each shape
+		physics::vec_2<real> point_a {};
+		physics::vec_2<real> point_b {};
+
+		// Unit vector pointing from shape a to shape b
+		physics::vec_2<real> normal {};
+
+		// Number of support points GJK needed
+		size_t iterations { 0 };
+	};
+
+	using distance_result = basic_distance_result<double>;
+
+	// Finds the closest points of two convex shapes with GJK
+	// Every shape is treated as the convex hull of its vertices (the center of circles) grown by its radius,
+	// so each iteration only needs the furthest vertex of each shape in a direction and the query costs O(n + m)
+	template <typename real>
+	physics::basic_distance_result<real> get_distance(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b);
+
+	template <typename real>
+	physics::basic_distance_result<real> get_distance(physics::basic_body<real>* body_a, physics::basic_body<real>* body_b);
+
+	// Checks for a collision between two convex shapes with GJK, using EPA for the penetration when their vertex hulls overlap
+	// Returns true if a collision was detected
+	template <typename real>
+	bool get_gjk_collision(const physics::basic_shape_view<real>& shape_a, const physics::basic_shape_view<real>& shape_b, physics::basic_collision_manifold<real>& collision);
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "integrator.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PHYSICS_X86
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PHYSICS_TARGET_AVX2
+#else
+#define PHYSICS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace physics
+{
+	// Pointers to the arrays used by the integrator
+	template <typename real>
+	struct integration_arrays
+	{
+		real* position_x { nullptr };
+		real* position_y { nullptr };
+		real* velocity_x { nullptr };
+		real* velocity_y { nullptr };
+		real* rotation { nullptr };
+		real* force_x { nullptr };
+		real* force_y { nullptr };
+		const real* angular_velocity { nullptr };
+		const real* inv_mass { nullptr };
+		const real* motion_mask { nullptr };
+		uint8_t* shape_dirty { nullptr };
+	};
+
+	// Integrates bodies [begin, end) one at a time
+	template <typename real>
+	void integrate_scalar(const physics::integration_arrays<real>& arrays, physics::vec_2<real> gravity, real dt, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			real mask = arrays.motion_mask[i];
+
+			// obj.force * inv_mass
+			real acceleration_x = (gravity.x + arrays.force_x[i] * arrays.inv_mass[i]) * mask;
+			real acceleration_y = (gravity.y + arrays.force_y[i] * arrays.inv_mass[i]) * mask;
+
+			// Velocity verlet integration
+			real displacement_x = (arrays.velocity_x[i] * dt + real(0.5) * acceleration_x * dt * dt) * mask;
+			real displacement_y = (arrays.velocity_y[i] * dt + real(0.5) * acceleration_y * dt * dt) * mask;
+			real angular_displacement = arrays.angular_velocity[i] * dt * mask;
+
+			arrays.position_x[i] += displacement_x;
+			arrays.position_y[i] += displacement_y;
+
+			arrays.velocity_x[i] += acceleration_x * dt;
+			arrays.velocity_y[i] += acceleration_y * dt;
+
+			arrays.rotation[i] += angular_displacement;
+
+			// Bodies that moved need their shape updated
+			if (displacement_x != 0 || displacement_y != 0 || angular_displacement != 0)
+				arrays.shape_dirty[i] = 1;
+
+			arrays.force_x[i] = 0;
+			arrays.force_y[i] = 0;
+		}
+	}
+
+#ifdef PHYSICS_X86
+	// Integrates 2 double precision bodies per iteration, returns the number of bodies integrated
+	// Operations are performed in the same order as the scalar loop so results are identical
+	size_t integrate_sse2(const physics::integration_arrays<double>& arrays, physics::vec_2d gravity, double dt, size_t count)
+	{
+		const __m128d gravity_x = _mm_set1_pd(gravity.x);
+		const __m128d gravity_y = _mm_set1_pd(gravity.y);
+		const __m128d dt_2 = _mm_set1_pd(dt);
+		const __m128d half = _mm_set1_pd(0.5);
+		const __m128d zero = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128d mask = _mm_loadu_pd(arrays.motion_mask + i);
+			__m128d inv_mass = _mm_loadu_pd(arrays.inv_mass + i);
+
+			__m128d acceleration_x = _mm_mul_pd(_mm_add_pd(gravity_x, _mm_mul_pd(_mm_loadu_pd(arrays.force_x + i), inv_mass)), mask);
+			__m128d acceleration_y = _mm_mul_pd(_mm_add_pd(gravity_y, _mm_mul_pd(_mm_loadu_pd(arrays.force_y + i), inv_mass)), mask);
+
+			__m128d velocity_x = _mm_loadu_pd(arrays.velocity_x + i);
+			__m128d velocity_y = _mm_loadu_pd(arrays.velocity_y + i);
+
+			__m128d displacement_x = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(velocity_x, dt_2), _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, acceleration_x), dt_2), dt_2)), mask);
+			__m128d displacement_y = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(velocity_y, dt_2), _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, acceleration_y), dt_2), dt_2)), mask);
+
+			_mm_storeu_pd(arrays.position_x + i, _mm_add_pd(_mm_loadu_pd(arrays.position_x + i), displacement_x));
+			_mm_storeu_pd(arrays.position_y + i, _mm_add_pd(_mm_loadu_pd(arrays.position_y + i), displacement_y));
+
+			_mm_storeu_pd(arrays.velocity_x + i, _mm_add_pd(velocity_x, _mm_mul_pd(acceleration_x, dt_2)));
+			_mm_storeu_pd(arrays.velocity_y + i, _mm_add_pd(velocity_y, _mm_mul_pd(acceleration_y, dt_2)));
+
+			__m128d angular_displacement = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(arrays.angular_velocity + i), dt_2), mask);
+			_mm_storeu_pd(arrays.rotation + i, _mm_add_pd(_mm_loadu_pd(arrays.rotation + i), angular_displacement));
+
+			__m128d moved = _mm_or_pd(_mm_or_pd(_mm_cmpneq_pd(displacement_x, zero), _mm_cmpneq_pd(displacement_y, zero)), _mm_cmpneq_pd(angular_displacement, zero));
+			int moved_bits = _mm_movemask_pd(moved);
+
+			arrays.shape_dirty[i] |= moved_bits & 1;
+			arrays.shape_dirty[i + 1] |= (moved_bits >> 1) & 1;
+
+			_mm_storeu_pd(arrays.force_x + i, zero);
+			_mm_storeu_pd(arrays.force_y + i, zero);
+		}
+
+		return i;
+	}
+
+	// Integrates 4 double precision bodies per iteration, returns the number of bodies integrated
+	PHYSICS_TARGET_AVX2 size_t integrate_avx2(const physics::integration_arrays<double>& arrays, physics::vec_2d gravity, double dt, size_t count)
+	{
+		const __m256d gravity_x = _mm256_set1_pd(gravity.x);
+		const __m256d gravity_y = _mm256_set1_pd(gravity.y);
+		const __m256d dt_4 = _mm256_set1_pd(dt);
+		const __m256d half = _mm256_set1_pd(0.5);
+		const __m256d zero = _mm256_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m256d mask = _mm256_loadu_pd(arrays.motion_mask + i);
+			__m256d inv_mass = _mm256_loadu_pd(arrays.inv_mass + i);
+
+			__m256d acceleration_x = _mm256_mul_pd(_mm256_add_pd(gravity_x, _mm256_mul_pd(_mm256_loadu_pd(arrays.force_x + i), inv_mass)), mask);
+			__m256d acceleration_y = _mm256_mul_pd(_mm256_add_pd(gravity_y, _mm256_mul_pd(_mm256_loadu_pd(arrays.force_y + i), inv_mass)), mask);
+
+			__m256d velocity_x = _mm256_loadu_pd(arrays.velocity_x + i);
+			__m256d velocity_y = _mm256_loadu_pd(arrays.velocity_y + i);
+
+			__m256d displacement_x = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(velocity_x, dt_4), _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, acceleration_x), dt_4), dt_4)), mask);
+			__m256d displacement_y = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(velocity_y, dt_4), _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, acceleration_y), dt_4), dt_4)), mask);
+
+			_mm256_storeu_pd(arrays.position_x + i, _mm256_add_pd(_mm256_loadu_pd(arrays.position_x + i), displacement_x));
+			_mm256_storeu_pd(arrays.position_y + i, _mm256_add_pd(_mm256_loadu_pd(arrays.position_y + i), displacement_y));
+
+			_mm256_storeu_pd(arrays.velocity_x + i, _mm256_add_pd(velocity_x, _mm256_mul_pd(acceleration_x, dt_4)));
+			_mm256_storeu_pd(arrays.velocity_y + i, _mm256_add_pd(velocity_y, _mm256_mul_pd(acceleration_y, dt_4)));
+
+			__m256d angular_displacement = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(arrays.angular_velocity + i), dt_4), mask);
+			_mm256_storeu_pd(arrays.rotation + i, _mm256_add_pd(_mm256_loadu_pd(arrays.rotation + i), angular_displacement));
+
+			__m256d moved = _mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(displacement_x, zero, _CMP_NEQ_UQ), _mm256_cmp_pd(displacement_y, zero, _CMP_NEQ_UQ)), _mm256_cmp_pd(angular_displacement, zero, _CMP_NEQ_UQ));
+			int moved_bits = _mm256_movemask_pd(moved);
+
+			for (int lane = 0; lane < 4; lane++)
+				arrays.shape_dirty[i + lane] |= (moved_bits >> lane) & 1;
+
+			_mm256_storeu_pd(arrays.force_x + i, zero);
+			_mm256_storeu_pd(arrays.force_y + i, zero);
+		}
+
+		return i;
+	}
+
+	// Integrates 4 single precision bodies per iteration, returns the number of bodies integrated
+	size_t integrate_sse2(const physics::integration_arrays<float>& arrays, physics::vec_2f gravity, float dt, size_t count)
+	{
+		const __m128 gravity_x = _mm_set1_ps(gravity.x);
+		const __m128 gravity_y = _mm_set1_ps(gravity.y);
+		const __m128 dt_4 = _mm_set1_ps(dt);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 mask = _mm_loadu_ps(arrays.motion_mask + i);
+			__m128 inv_mass = _mm_loadu_ps(arrays.inv_mass + i);
+
+			__m128 acceleration_x = _mm_mul_ps(_mm_add_ps(gravity_x, _mm_mul_ps(_mm_loadu_ps(arrays.force_x + i), inv_mass)), mask);
+			__m128 acceleration_y = _mm_mul_ps(_mm_add_ps(gravity_y, _mm_mul_ps(_mm_loadu_ps(arrays.force_y + i), inv_mass)), mask);
+
+			__m128 velocity_x = _mm_loadu_ps(arrays.velocity_x + i);
+			__m128 velocity_y = _mm_loadu_ps(arrays.velocity_y + i);
+
+			__m128 displacement_x = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(velocity_x, dt_4), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, acceleration_x), dt_4), dt_4)), mask);
+			__m128 displacement_y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(velocity_y, dt_4), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, acceleration_y), dt_4), dt_4)), mask);
+
+			_mm_storeu_ps(arrays.position_x + i, _mm_add_ps(_mm_loadu_ps(arrays.position_x + i), displacement_x));
+			_mm_storeu_ps(arrays.position_y + i, _mm_add_ps(_mm_loadu_ps(arrays.position_y + i), displacement_y));
+
+			_mm_storeu_ps(arrays.velocity_x + i, _mm_add_ps(velocity_x, _mm_mul_ps(acceleration_x, dt_4)));
+			_mm_storeu_ps(arrays.velocity_y + i, _mm_add_ps(velocity_y, _mm_mul_ps(acceleration_y, dt_4)));
+
+			__m128 angular_displacement = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(arrays.angular_velocity + i), dt_4), mask);
+			_mm_storeu_ps(arrays.rotation + i, _mm_add_ps(_mm_loadu_ps(arrays.rotation + i), angular_displacement));
+
+			__m128 moved = _mm_or_ps(_mm_or_ps(_mm_cmpneq_ps(displacement_x, zero), _mm_cmpneq_ps(displacement_y, zero)), _mm_cmpneq_ps(angular_displacement, zero));
+			int moved_bits = _mm_movemask_ps(moved);
+
+			for (int lane = 0; lane < 4; lane++)
+				arrays.shape_dirty[i + lane] |= (moved_bits >> lane) & 1;
+
+			_mm_storeu_ps(arrays.force_x + i, zero);
+			_mm_storeu_ps(arrays.force_y + i, zero);
+		}
+
+		return i;
+	}
+
+	// Integrates 8 single precision bodies per iteration, returns the number of bodies integrated
+	PHYSICS_TARGET_AVX2 size_t integrate_avx2(const physics::integration_arrays<float>& arrays, physics::vec_2f gravity, float dt, size_t count)
+	{
+		const __m256 gravity_x = _mm256_set1_ps(gravity.x);
+		const __m256 gravity_y = _mm256_set1_ps(gravity.y);
+		const __m256 dt_8 = _mm256_set1_ps(dt);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 mask = _mm256_loadu_ps(arrays.motion_mask + i);
+			__m256 inv_mass = _mm256_loadu_ps(arrays.inv_mass + i);
+
+			__m256 acceleration_x = _mm256_mul_ps(_mm256_add_ps(gravity_x, _mm256_mul_ps(_mm256_loadu_ps(arrays.force_x + i), inv_mass)), mask);
+			__m256 acceleration_y = _mm256_mul_ps(_mm256_add_ps(gravity_y, _mm256_mul_ps(_mm256_loadu_ps(arrays.force_y + i), inv_mass)), mask);
+
+			__m256 velocity_x = _mm256_loadu_ps(arrays.velocity_x + i);
+			__m256 velocity_y = _mm256_loadu_ps(arrays.velocity_y + i);
+
+			__m256 displacement_x = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(velocity_x, dt_8), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(half, acceleration_x), dt_8), dt_8)), mask);
+			__m256 displacement_y = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(velocity_y, dt_8), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(half, acceleration_y), dt_8), dt_8)), mask);
+
+			_mm256_storeu_ps(arrays.position_x + i, _mm256_add_ps(_mm256_loadu_ps(arrays.position_x + i), displacement_x));
+			_mm256_storeu_ps(arrays.position_y + i, _mm256_add_ps(_mm256_loadu_ps(arrays.position_y + i), displacement_y));
+
+			_mm256_storeu_ps(arrays.velocity_x + i, _mm256_add_ps(velocity_x, _mm256_mul_ps(acceleration_x, dt_8)));
+			_mm256_storeu_ps(arrays.velocity_y + i, _mm256_add_ps(velocity_y, _mm256_mul_ps(acceleration_y, dt_8)));
+
+			__m256 angular_displacement = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(arrays.angular_velocity + i), dt_8), mask);
+			_mm256_storeu_ps(arrays.rotation + i, _mm256_add_ps(_mm256_loadu_ps(arrays.rotation + i), angular_displacement));
+
+			__m256 moved = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(displacement_x, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(displacement_y, zero, _CMP_NEQ_UQ)), _mm256_cmp_ps(angular_displacement, zero, _CMP_NEQ_UQ));
+			int moved_bits = _mm256_movemask_ps(moved);
+
+			for (int lane = 0; lane < 8; lane++)
+				arrays.shape_dirty[i + lane] |= (moved_bits >> lane) & 1;
+
+			_mm256_storeu_ps(arrays.force_x + i, zero);
+			_mm256_storeu_ps(arrays.force_y + i, zero);
+		}
+
+		return i;
+	}
+
+	physics::simd_level detect_simd_level()
+	{
+#if defined(_MSC_VER)
+		int info[4] {};
+		__cpuid(info, 0);
+
+		if (info[0] >= 7)
+		{
+			__cpuid(info, 1);
+			bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+			bool has_avx = (info[2] & (1 << 28)) != 0;
+
+			__cpuidex(info, 7, 0);
+			bool has_avx2 = (info[1] & (1 << 5)) != 0;
+
+			if (os_saves_ymm && has_avx && has_avx2)
+				return physics::simd_level::avx2;
+		}
+
+		// SSE2 is part of the x64 baseline
+		return physics::simd_level::sse2;
+#else
+		if (__builtin_cpu_supports("avx2"))
+			return physics::simd_level::avx2;
+
+		if (__builtin_cpu_supports("sse2"))
+			return physics::simd_level::sse2;
+
+		return physics::simd_level::scalar;
+#endif
+	}
+#else
+	physics::simd_level detect_simd_level()
+	{
+		return physics::simd_level::scalar;
+	}
+#endif
+
+	physics::simd_level get_supported_simd_level()
+	{
+		static const physics::simd_level supported_level = detect_simd_level();
+		return supported_level;
+	}
+
+	template <typename real>
+	void integrate_motion(physics::basic_body_storage<real>& storage, physics::vec_2<real> gravity, std::type_identity_t<real> dt, physics::simd_level level)
+	{
+		integrate_motion(storage, gravity, dt, level, 0, storage.size());
+	}
+
+	template <typename real>
+	void integrate_motion(physics::basic_body_storage<real>& storage, physics::vec_2<real> gravity, std::type_identity_t<real> dt, physics::simd_level level, size_t begin, size_t end)
+	{
+		// Offset the arrays so the range starts at 0
+		physics::integration_arrays<real> arrays {};
+		arrays.position_x = storage.position_x.data() + begin;
+		arrays.position_y = storage.position_y.data() + begin;
+		arrays.velocity_x = storage.velocity_x.data() + begin;
+		arrays.velocity_y = storage.velocity_y.data() + begin;
+		arrays.rotation = storage.rotation.data() + begin;
+		arrays.force_x = storage.force_x.data() + begin;
+		arrays.force_y = storage.force_y.data() + begin;
+		arrays.angular_velocity = storage.angular_velocity.data() + begin;
+		arrays.inv_mass = storage.inv_mass.data() + begin;
+		arrays.motion_mask = storage.motion_mask.data() + begin;
+		arrays.shape_dirty = storage.shape_dirty.data() + begin;
+
+		size_t count = end - begin;
+		size_t integrated = 0;
+
+		level = std::min(level, get_supported_simd_level());
+
+#ifdef PHYSICS_X86
+		if (level == physics::simd_level::avx2)
+			integrated = integrate_avx2(arrays, gravity, dt, count);
+		else if (level == physics::simd_level::sse2)
+			integrated = integrate_sse2(arrays, gravity, dt, count);
+#endif
+
+		// Remaining bodies (or all bodies without SIMD support)
+		integrate_scalar(arrays, gravity, dt, integrated, count);
+	}
+
+	template void integrate_motion<float>(physics::basic_body_storage<float>&, physics::vec_2f, float, physics::simd_level);
+	template void integrate_motion<float>(physics::basic_body_storage<float>&, physics::vec_2f, float, physics::simd_level, size_t, size_t);
+
+	template void integrate_motion<double>(physics::basic_body_storage<double>&, physics::vec_2d, double, physics::simd_level);
+	template void integrate_motion<double>(physics::basic_body_storage<double>&, physics::vec_2d, double, physics::simd_level, size_t, size_t);
+}
\ No newline at end of file
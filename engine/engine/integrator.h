@@ -0,0 +1,28 @@
+#pragma once
+
+#include "body_storage.h"
+
+namespace physics
+{
+	// Instruction sets the integrator can use
+	enum class simd_level
+	{
+		scalar,
+		sse2,
+		avx2
+	};
+
+	// Returns the best instruction set supported by the CPU (detected once)
+	physics::simd_level get_supported_simd_level();
+
+	// Integrates the position and velocity of every body in the storage over a timestep using velocity verlet
+	// Bodies with a motion mask of 0 (static or massless) are left unchanged, and forces are cleared
+	// All instruction sets produce identical results, the requested level is clamped to what the CPU supports
+	// Float storage is integrated with twice as many bodies per instruction as double storage
+	template <typename real>
+	void integrate_motion(physics::basic_body_storage<real>& storage, physics::vec_2<real> gravity, std::type_identity_t<real> dt, physics::simd_level level);
+
+	// Integrates the bodies in storage slots [begin, end)
+	template <typename real>
+	void integrate_motion(physics::basic_body_storage<real>& storage, physics::vec_2<real> gravity, std::type_identity_t<real> dt, physics::simd_level level, size_t begin, size_t end);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "island.h"
+#include <algorithm>
+
+namespace physics
+{
+	template <typename real>
+	uint32_t basic_island_set<real>::find(uint32_t index)
+	{
+		// Path halving
+		while (parent[index] != index)
+		{
+			parent[index] = parent[parent[index]];
+			index = parent[index];
+		}
+
+		return index;
+	}
+
+	template <typename real>
+	void basic_island_set<real>::unite(uint32_t index_a, uint32_t index_b)
+	{
+		uint32_t root_a = find(index_a);
+		uint32_t root_b = find(index_b);
+
+		if (root_a == root_b)
+			return;
+
+		// Attach the smaller tree under the larger one
+		if (size[root_a] < size[root_b])
+			std::swap(root_a, root_b);
+
+		parent[root_b] = root_a;
+		size[root_a] += size[root_b];
+	}
+
+	template <typename real>
+	void basic_island_set<real>::build(const physics::basic_body_storage<real>& storage, const std::vector<physics::basic_collision_manifold<real>>& contact_list)
+	{
+		uint32_t body_count = static_cast<uint32_t>(storage.size());
+
+		parent.resize(body_count);
+		size.assign(body_count, 1);
+
+		for (uint32_t i = 0; i < body_count; i++)
+			parent[i] = i;
+
+		// Static and sleeping bodies are left out so they don't join the islands of everything resting on them
+		auto in_island = [&](const physics::basic_body<real>* body)
+		{
+			return body->get_type() != physics::static_body && !storage.is_sleeping(body->index);
+		};
+
+		for (const physics::basic_collision_manifold<real>& contact : contact_list)
+		{
+			if (!in_island(contact.body_a) || !in_island(contact.body_b))
+				continue;
+
+			unite(static_cast<uint32_t>(contact.body_a->index), static_cast<uint32_t>(contact.body_b->index));
+		}
+
+		// Number islands by their lowest storage slot
+		body_islands.assign(body_count, no_island);
+		body_offsets.assign(1, 0);
+
+		for (uint32_t i = 0; i < body_count; i++)
+		{
+			if (!in_island(storage.bodies[i]))
+				continue;
+
+			uint32_t root = find(i);
+
+			if (body_islands[root] == no_island)
+			{
+				body_islands[root] = static_cast<uint32_t>(body_offsets.size() - 1);
+				body_offsets.push_back(0);
+			}
+
+			body_islands[i] = body_islands[root];
+			body_offsets[body_islands[i] + 1]++;
+		}
+
+		size_t island_count = body_offsets.size() - 1;
+
+		contact_offsets.assign(island_count + 1, 0);
+
+		for (const physics::basic_collision_manifold<real>& contact : contact_list)
+		{
+			size_t index = in_island(contact.body_a) ? contact.body_a->index : contact.body_b->index;
+			contact_offsets[body_islands[index] + 1]++;
+		}
+
+		largest_island = 0;
+
+		for (size_t i = 0; i < island_count; i++)
+		{
+			largest_island = std::max(largest_island, body_offsets[i + 1]);
+
+			body_offsets[i + 1] += body_offsets[i];
+			contact_offsets[i + 1] += contact_offsets[i];
+		}
+
+		// Group bodies and contacts by island (counting sort)
+		bodies.resize(body_offsets.back());
+		contacts.resize(contact_offsets.back());
+
+		next_index.assign(body_offsets.begin(), body_offsets.end() - 1);
+
+		for (uint32_t i = 0; i < body_count; i++)
+		{
+			if (body_islands[i] != no_island)
+				bodies[next_index[body_islands[i]]++] = i;
+		}
+
+		next_index.assign(contact_offsets.begin(), contact_offsets.end() - 1);
+
+		for (uint32_t i = 0; i < contact_list.size(); i++)
+		{
+			const physics::basic_collision_manifold<real>& contact = contact_list[i];
+			size_t index = in_island(contact.body_a) ? contact.body_a->index : contact.body_b->index;
+			contacts[next_index[body_islands[index]]++] = i;
+		}
+	}
+
+	template <typename real>
+	size_t basic_island_set<real>::get_island_count() const
+	{
+		return body_offsets.empty() ? 0 : body_offsets.size() - 1;
+	}
+
+	template <typename real>
+	size_t basic_island_set<real>::get_largest_island() const
+	{
+		return largest_island;
+	}
+
+	template class basic_island_set<float>;
+	template class basic_island_set<double>;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "body_storage.h"
+#include "collision.h"
+
+namespace physics
+{
+	// Groups dynamic bodies connected through contacts into islands that can be solved independently
+	// Static bodies do not connect islands, and static and sleeping bodies belong to none
+	template <typename real>
+	class basic_island_set
+	{
+	private:
+		// Union-find parent and size of each storage slot
+		std::vector<uint32_t> parent {};
+		std::vector<uint32_t> size {};
+
+		// Next free position of each island while grouping
+		std::vector<size_t> next_index {};
+
+		size_t largest_island { 0 };
+
+		uint32_t find(uint32_t index);
+		void unite(uint32_t index_a, uint32_t index_b);
+
+	public:
+		static constexpr uint32_t no_island = UINT32_MAX;
+
+		// Island of each storage slot (no_island for static and sleeping bodies)
+		std::vector<uint32_t> body_islands {};
+
+		// Storage slots of each island, grouped by island
+		// The bodies of island i are bodies[body_offsets[i]] to bodies[body_offsets[i + 1] - 1]
+		std::vector<uint32_t> bodies {};
+		std::vector<size_t> body_offsets {};
+
+		// Indices into the contact list grouped by island, in the same layout as bodies
+		std::vector<uint32_t> contacts {};
+		std::vector<size_t> contact_offsets {};
+
+		// Builds islands from the contacts found this step
+		// Islands are numbered in order of their lowest storage slot and keep the contact order
+		void build(const physics::basic_body_storage<real>& storage, const std::vector<physics::basic_collision_manifold<real>>& contact_list);
+
+		size_t get_island_count() const;
+
+		// Number of bodies in the largest island
+		size_t get_largest_island() const;
+	};
+
+	using island_set = basic_island_set<double>;
+}
\ No newline at end of file
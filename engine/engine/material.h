@@ -2,20 +2,24 @@
 
 namespace physics
 {
-	struct material
+	template <typename real>
+	struct basic_material
 	{
 		// Material density in kg/m^2
-		double density { 1.0 };
+		real density { real(1.0) };
 
 		// Coefficient of static friction 
-		double static_friction { 0.4 };
+		real static_friction { real(0.4) };
 
 		// Coefficient of kinetic friction 
-		double kinetic_friction { 0.3 };
+		real kinetic_friction { real(0.3) };
 		
 		// Coefficeint of restitution (elasticity)
-		double restitution { 0.8 };
+		real restitution { real(0.8) };
 
-		material() = default;
+		basic_material() = default;
 	};
+
+	using material = basic_material<double>;
+	using materialf = basic_material<float>;
 }
\ No newline at end of file
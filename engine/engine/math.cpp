@@ -1,108 +1,138 @@
 #include "math.h"
 #include <cmath>
+#include <cstdint>
 
 namespace physics
 {
-	vec_2d::vec_2d(double x, double y)
-		: x(x), y(y)
-	{}
-
-	vec_2d vec_add(vec_2d lhs, vec_2d rhs)
-	{
-		return vec_2d(lhs.x + rhs.x, lhs.y + rhs.y);
+	// Reduces an angle to [-pi/4, pi/4] and returns the quarter turn it was reduced by
+	// Pi/2 is split into three parts so each product with the quarter turn count is exact for angles up to about 1e6
+	int reduce_angle(double theta, double& reduced)
+	{
+		constexpr double two_over_pi = 6.36619772367581382433e-01;
+		constexpr double pi_over_2_1 = 1.57079632673412561417e+00;
+		constexpr double pi_over_2_2 = 6.07710050630396597660e-11;
+		constexpr double pi_over_2_3 = 2.02226624871116645580e-21;
+
+		double quarter_turns = std::floor(theta * two_over_pi + 0.5);
+		reduced = ((theta - quarter_turns * pi_over_2_1) - quarter_turns * pi_over_2_2) - quarter_turns * pi_over_2_3;
+
+		return static_cast<int>(static_cast<int64_t>(quarter_turns) & 3);
+	}
+
+	// Minimax polynomials for sine and cosine on [-pi/4, pi/4] (from fdlibm)
+	double sin_kernel(double x)
+	{
+		constexpr double s1 = -1.66666666666666324348e-01;
+		constexpr double s2 = 8.33333333332248946124e-03;
+		constexpr double s3 = -1.98412698298579493134e-04;
+		constexpr double s4 = 2.75573137070700676789e-06;
+		constexpr double s5 = -2.50507602534068634195e-08;
+		constexpr double s6 = 1.58969099521155010221e-10;
+
+		double z = x * x;
+		double r = s2 + z * (s3 + z * (s4 + z * (s5 + z * s6)));
+
+		return x + x * z * (s1 + z * r);
 	}
 
-	vec_2d vec_sub(vec_2d lhs, vec_2d rhs)
+	double cos_kernel(double x)
 	{
-		return vec_2d(lhs.x - rhs.x, lhs.y - rhs.y);
-	}
+		constexpr double c1 = 4.16666666666666019037e-02;
+		constexpr double c2 = -1.38888888888741095749e-03;
+		constexpr double c3 = 2.48015872894767294178e-05;
+		constexpr double c4 = -2.75573143513906633035e-07;
+		constexpr double c5 = 2.08757232129817482790e-09;
+		constexpr double c6 = -1.13596475577881948265e-11;
 
-	double vec_dot(vec_2d lhs, vec_2d rhs)
-	{
-		return lhs.x * rhs.x + lhs.y * rhs.y;
-	}
+		double z = x * x;
+		double r = z * (c1 + z * (c2 + z * (c3 + z * (c4 + z * (c5 + z * c6)))));
+		double half_z = 0.5 * z;
+		double w = 1.0 - half_z;
 
-	double vec_cross(vec_2d lhs, vec_2d rhs)
-	{
-		return lhs.x * rhs.y - lhs.y * rhs.x;
+		// Recovers the rounding error of 1 - z/2
+		return w + (((1.0 - w) - half_z) + z * r);
 	}
 
-	vec_2d vec_cross(vec_2d vector, double factor)
+	double deterministic_sin(double theta)
 	{
-		return vec_2d(vector.y * factor, -vector.x * factor);
+		double x;
+		switch (reduce_angle(theta, x))
+		{
+		case 0: return sin_kernel(x);
+		case 1: return cos_kernel(x);
+		case 2: return -sin_kernel(x);
+		default: return -cos_kernel(x);
+		}
 	}
 
-	vec_2d vec_mul(vec_2d lhs, vec_2d rhs)
+	double deterministic_cos(double theta)
 	{
-		return vec_2d(lhs.x * rhs.x, lhs.y * rhs.y);
+		double x;
+		switch (reduce_angle(theta, x))
+		{
+		case 0: return cos_kernel(x);
+		case 1: return -sin_kernel(x);
+		case 2: return -cos_kernel(x);
+		default: return sin_kernel(x);
+		}
 	}
 
-	vec_2d vec_mul(vec_2d vector, double factor)
+	// Arctangent of a non-negative number (from fdlibm)
+	double atan_positive(double x)
 	{
-		return vec_2d(vector.x * factor, vector.y * factor);
-	}
+		constexpr double atan_high[] = { 4.63647609000806093515e-01, 7.85398163397448278999e-01, 9.82793723247329054082e-01, 1.57079632679489655800e+00 };
+		constexpr double atan_low[] = { 2.26987774529616870924e-17, 3.06161699786838301793e-17, 1.39033110312309984516e-17, 6.12323399573676603587e-17 };
+		constexpr double a[] = {
+			3.33333333333329318027e-01, -1.99999999998764832476e-01, 1.42857142725034663711e-01, -1.11111104054623557880e-01,
+			9.09088713343650656196e-02, -7.69187620504482999495e-02, 6.66107313738753120669e-02, -5.83357013379057348645e-02,
+			4.97687799461593236017e-02, -3.65315727442169155270e-02, 1.62858201153657823623e-02
+		};
 
-	vec_2d vec_div(vec_2d vector, double factor)
-	{
-		return vec_2d(vector.x / factor, vector.y / factor);
-	}
+		// Reduce the argument around atan(0.5), atan(1), atan(1.5) or atan(infinity)
+		int interval = -1;
+		if (x >= 2.4375)
+		{
+			interval = 3;
+			x = -1.0 / x;
+		}
+		else if (x >= 1.1875)
+		{
+			interval = 2;
+			x = (x - 1.5) / (1.0 + 1.5 * x);
+		}
+		else if (x >= 0.6875)
+		{
+			interval = 1;
+			x = (x - 1.0) / (x + 1.0);
+		}
+		else if (x >= 0.4375)
+		{
+			interval = 0;
+			x = (2.0 * x - 1.0) / (2.0 + x);
+		}
 
-	double vec_magnitude_sq(vec_2d vector)
-	{
-		return vector.x * vector.x + vector.y * vector.y;
-	}
+		// Odd and even terms are summed separately
+		double z = x * x;
+		double w = z * z;
+		double odd = z * (a[0] + w * (a[2] + w * (a[4] + w * (a[6] + w * (a[8] + w * a[10])))));
+		double even = w * (a[1] + w * (a[3] + w * (a[5] + w * (a[7] + w * a[9]))));
 
-	double vec_magnitude(vec_2d vector)
-	{
-		return std::sqrt(vector.x * vector.x + vector.y * vector.y);
-	}
-
-	vec_2d vec_normalize(vec_2d vector)
-	{
-		double inv_magnitude = 1.0 / vec_magnitude(vector);
-		return vec_2d(vector.x * inv_magnitude, vector.y * inv_magnitude);
-	}
-
-	double get_distance(vec_2d lhs, vec_2d rhs)
-	{
-		double dx = lhs.x - rhs.x;
-		double dy = lhs.y - rhs.y;
-		return std::sqrt(dx * dx + dy * dy);
-	}
+		if (interval < 0)
+			return x - x * (odd + even);
+
+		return atan_high[interval] - ((x * (odd + even) - atan_low[interval]) - x);
+	}
+
+	double deterministic_atan2(double y, double x)
+	{
+		if (x == 0.0)
+			return y > 0.0 ? physics::pi / 2.0 : y < 0.0 ? -physics::pi / 2.0 : 0.0;
 
-	double get_distance_sq(vec_2d lhs, vec_2d rhs)
-	{
-		double dx = lhs.x - rhs.x;
-		double dy = lhs.y - rhs.y;
-		return dx * dx + dy * dy;
-	}
-
-	vec_2d rotate_point(vec_2d point, double theta)
-	{
-		return vec_2d(point.x * std::cos(theta) - point.y * std::sin(theta), point.y * cos(theta) + point.x * sin(theta));
-	}
-
-	double deg_to_rad(double theta)
-	{
-		return theta * physics::pi / 180.0;
-	}
-
-	double rad_to_deg(double theta)
-	{
-		return theta * 180.0 / physics::pi;
-	}
-
-	bool equals(double lhs, double rhs)
-	{
-		return std::fabs(lhs - rhs) < fp_compare_epsilon;
-	}
-
-	bool vec_equals(vec_2d lhs, vec_2d rhs)
-	{
-		return equals(lhs.x, rhs.x) && equals(lhs.y, rhs.y);
-	}
-	double square(double number)
-	{
-		return number * number;
+		double angle = atan_positive(std::fabs(y / x));
+
+		if (x < 0.0)
+			angle = physics::pi - angle;
+
+		return y < 0.0 ? -angle : angle;
 	}
 }
\ No newline at end of file
@@ -1,44 +1,362 @@
 #pragma once
 
+#include <cmath>
+#include <type_traits>
+
+// SSE2 is always available on x64, and on x86 when the compiler targets it
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PHYSICS_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace physics
 {
-	// 2D vector class
-	struct vec_2d
+	// 2D vector class, templated on the scalar type
+	// The vector math is defined in this header so the tiny functions inline into the engine's hot loops
+	template <typename real>
+	struct vec_2
 	{
-		double x { 0.0 };
-		double y { 0.0 };
+		real x { 0 };
+		real y { 0 };
 
-		vec_2d() = default;
-		vec_2d(double x, double y);
+		constexpr vec_2() noexcept = default;
+		constexpr vec_2(real x, real y) noexcept
+			: x(x), y(y)
+		{}
+
+		constexpr vec_2& operator+=(vec_2 rhs) noexcept;
+		constexpr vec_2& operator-=(vec_2 rhs) noexcept;
+		constexpr vec_2& operator*=(real factor) noexcept;
+		constexpr vec_2& operator/=(real factor) noexcept;
 	};
 
-	const vec_2d vec_zero { 0.0, 0.0 };
+	using vec_2d = vec_2<double>;
+	using vec_2f = vec_2<float>;
+
+	constexpr vec_2d vec_zero { 0.0, 0.0 };
+
+	template <typename real>
+	constexpr vec_2<real> operator+(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return { lhs.x + rhs.x, lhs.y + rhs.y };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> operator-(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return { lhs.x - rhs.x, lhs.y - rhs.y };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> operator-(vec_2<real> vector) noexcept
+	{
+		return { -vector.x, -vector.y };
+	}
+
+	// Component-wise product
+	template <typename real>
+	constexpr vec_2<real> operator*(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return { lhs.x * rhs.x, lhs.y * rhs.y };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> operator*(vec_2<real> vector, std::type_identity_t<real> factor) noexcept
+	{
+		return { vector.x * factor, vector.y * factor };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> operator*(std::type_identity_t<real> factor, vec_2<real> vector) noexcept
+	{
+		return vector * factor;
+	}
+
+	template <typename real>
+	constexpr vec_2<real> operator/(vec_2<real> vector, std::type_identity_t<real> factor) noexcept
+	{
+		return { vector.x / factor, vector.y / factor };
+	}
+
+	template <typename real>
+	constexpr real vec_dot(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y;
+	}
+
+	template <typename real>
+	constexpr real vec_cross(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return lhs.x * rhs.y - lhs.y * rhs.x;
+	}
+
+#ifdef PHYSICS_SSE2
+	// Double vectors are packed into one SSE2 register so each operation handles both components in one instruction
+	// Every lane does the same IEEE operation as the scalar code, so results are bit-identical (and deterministic)
+	// Constant evaluation can't use intrinsics and takes the scalar path
+	static_assert(sizeof(vec_2d) == 2 * sizeof(double));
+
+	inline __m128d vec_load(vec_2d vector) noexcept
+	{
+		return _mm_loadu_pd(&vector.x);
+	}
+
+	inline vec_2d vec_store(__m128d packed) noexcept
+	{
+		vec_2d vector;
+		_mm_storeu_pd(&vector.x, packed);
+		return vector;
+	}
+
+	template <>
+	constexpr vec_2d operator+(vec_2d lhs, vec_2d rhs) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return { lhs.x + rhs.x, lhs.y + rhs.y };
+
+		return vec_store(_mm_add_pd(vec_load(lhs), vec_load(rhs)));
+	}
+
+	template <>
+	constexpr vec_2d operator-(vec_2d lhs, vec_2d rhs) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return { lhs.x - rhs.x, lhs.y - rhs.y };
+
+		return vec_store(_mm_sub_pd(vec_load(lhs), vec_load(rhs)));
+	}
+
+	template <>
+	constexpr vec_2d operator*(vec_2d lhs, vec_2d rhs) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return { lhs.x * rhs.x, lhs.y * rhs.y };
+
+		return vec_store(_mm_mul_pd(vec_load(lhs), vec_load(rhs)));
+	}
+
+	template <>
+	constexpr vec_2d operator*(vec_2d vector, double factor) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return { vector.x * factor, vector.y * factor };
+
+		return vec_store(_mm_mul_pd(vec_load(vector), _mm_set1_pd(factor)));
+	}
+
+	template <>
+	constexpr vec_2d operator/(vec_2d vector, double factor) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return { vector.x / factor, vector.y / factor };
+
+		return vec_store(_mm_div_pd(vec_load(vector), _mm_set1_pd(factor)));
+	}
+
+	template <>
+	constexpr double vec_dot(vec_2d lhs, vec_2d rhs) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return lhs.x * rhs.x + lhs.y * rhs.y;
+
+		__m128d product = _mm_mul_pd(vec_load(lhs), vec_load(rhs));
+		return _mm_cvtsd_f64(_mm_add_sd(product, _mm_unpackhi_pd(product, product)));
+	}
+
+	template <>
+	constexpr double vec_cross(vec_2d lhs, vec_2d rhs) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return lhs.x * rhs.y - lhs.y * rhs.x;
+
+		// (lhs.x * rhs.y, lhs.y * rhs.x)
+		__m128d product = _mm_mul_pd(vec_load(lhs), _mm_shuffle_pd(vec_load(rhs), vec_load(rhs), 1));
+		return _mm_cvtsd_f64(_mm_sub_sd(product, _mm_unpackhi_pd(product, product)));
+	}
+#endif
+
+	template <typename real>
+	constexpr vec_2<real>& vec_2<real>::operator+=(vec_2 rhs) noexcept
+	{
+		return *this = *this + rhs;
+	}
+
+	template <typename real>
+	constexpr vec_2<real>& vec_2<real>::operator-=(vec_2 rhs) noexcept
+	{
+		return *this = *this - rhs;
+	}
+
+	template <typename real>
+	constexpr vec_2<real>& vec_2<real>::operator*=(real factor) noexcept
+	{
+		return *this = *this * factor;
+	}
+
+	template <typename real>
+	constexpr vec_2<real>& vec_2<real>::operator/=(real factor) noexcept
+	{
+		return *this = *this / factor;
+	}
+
+	// The named functions predate the operators and are kept as thin wrappers
+	// Scalar arguments take the scalar type of the vector arguments, so literals of either type can be passed
+	template <typename real>
+	constexpr vec_2<real> vec_add(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return lhs + rhs;
+	}
+
+	template <typename real>
+	constexpr vec_2<real> vec_sub(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return lhs - rhs;
+	}
+
+	template <typename real>
+	constexpr vec_2<real> vec_cross(vec_2<real> vector, std::type_identity_t<real> factor) noexcept
+	{
+		return { vector.y * factor, -vector.x * factor };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> vec_mul(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return lhs * rhs;
+	}
+
+	template <typename real>
+	constexpr vec_2<real> vec_mul(vec_2<real> vector, std::type_identity_t<real> factor) noexcept
+	{
+		return vector * factor;
+	}
 
-	vec_2d vec_add(vec_2d lhs, vec_2d rhs);
-	vec_2d vec_sub(vec_2d lhs, vec_2d rhs);
-	double vec_dot(vec_2d lhs, vec_2d rhs);
-	double vec_cross(vec_2d lhs, vec_2d rhs);
-	vec_2d vec_cross(vec_2d vector, double factor);
-	vec_2d vec_mul(vec_2d lhs, vec_2d rhs);
-	vec_2d vec_mul(vec_2d vector, double factor);
-	vec_2d vec_div(vec_2d vector, double factor);
+	template <typename real>
+	constexpr vec_2<real> vec_div(vec_2<real> vector, std::type_identity_t<real> factor) noexcept
+	{
+		return vector / factor;
+	}
 
-	double vec_magnitude_sq(vec_2d vector);
-	double vec_magnitude(vec_2d vector);
-	vec_2d vec_normalize(vec_2d vector);
+	template <typename real>
+	constexpr real vec_magnitude_sq(vec_2<real> vector) noexcept
+	{
+		return vec_dot(vector, vector);
+	}
 
-	double get_distance(vec_2d lhs, vec_2d rhs);
-	double get_distance_sq(vec_2d lhs, vec_2d rhs);
+	// std::sqrt is not constexpr, so the functions using it are only inline
+	template <typename real>
+	real vec_magnitude(vec_2<real> vector) noexcept
+	{
+		return std::sqrt(vec_magnitude_sq(vector));
+	}
+
+	template <typename real>
+	vec_2<real> vec_normalize(vec_2<real> vector) noexcept
+	{
+		real inv_magnitude = real(1) / vec_magnitude(vector);
+		return vector * inv_magnitude;
+	}
+
+	template <typename real>
+	constexpr real get_distance_sq(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return vec_magnitude_sq(lhs - rhs);
+	}
+
+	template <typename real>
+	real get_distance(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return std::sqrt(get_distance_sq(lhs, rhs));
+	}
 
 	constexpr double pi = 3.14159265358979323846;
 
-	vec_2d rotate_point(vec_2d point, double theta);
-	double deg_to_rad(double theta);
-	double rad_to_deg(double theta);
+	// Rotation stored as the cosine and sine of its angle, applied as a 2x2 matrix
+	template <typename real>
+	struct basic_rotation_matrix
+	{
+		real cos_theta { 1 };
+		real sin_theta { 0 };
+	};
+
+	using rotation_matrix = basic_rotation_matrix<double>;
+
+	template <typename real>
+	basic_rotation_matrix<real> make_rotation_matrix(real theta) noexcept
+	{
+		return { std::cos(theta), std::sin(theta) };
+	}
+
+	// Sine, cosine and arctangent computed with only basic arithmetic, so every platform gives identical results
+	// The standard library versions are faster but their rounding depends on the platform
+	double deterministic_sin(double theta);
+	double deterministic_cos(double theta);
+	double deterministic_atan2(double y, double x);
+
+	// Evaluated in double precision and rounded, which is deterministic for float too
+	template <typename real>
+	basic_rotation_matrix<real> make_deterministic_rotation_matrix(real theta)
+	{
+		return { static_cast<real>(deterministic_cos(theta)), static_cast<real>(deterministic_sin(theta)) };
+	}
+
+	template <typename real>
+	constexpr vec_2<real> rotate_point(vec_2<real> point, const basic_rotation_matrix<real>& rotation) noexcept
+	{
+		return { point.x * rotation.cos_theta - point.y * rotation.sin_theta, point.y * rotation.cos_theta + point.x * rotation.sin_theta };
+	}
+
+	template <typename real>
+	vec_2<real> rotate_point(vec_2<real> point, std::type_identity_t<real> theta) noexcept
+	{
+		return rotate_point(point, make_rotation_matrix<real>(theta));
+	}
+
+	constexpr double deg_to_rad(double theta) noexcept
+	{
+		return theta * physics::pi / 180.0;
+	}
+
+	constexpr float deg_to_rad(float theta) noexcept
+	{
+		return theta * static_cast<float>(physics::pi) / 180.0f;
+	}
+
+	constexpr double rad_to_deg(double theta) noexcept
+	{
+		return theta * 180.0 / physics::pi;
+	}
+
+	constexpr float rad_to_deg(float theta) noexcept
+	{
+		return theta * 180.0f / static_cast<float>(physics::pi);
+	}
 
 	constexpr double fp_compare_epsilon = 1e-5;
-	bool equals(double lhs, double rhs);
-	bool vec_equals(vec_2d lhs, vec_2d rhs);
 
-	double square(double number);
+	inline bool equals(double lhs, double rhs) noexcept
+	{
+		return std::fabs(lhs - rhs) < fp_compare_epsilon;
+	}
+
+	inline bool equals(float lhs, float rhs) noexcept
+	{
+		return std::fabs(lhs - rhs) < static_cast<float>(fp_compare_epsilon);
+	}
+
+	template <typename real>
+	bool vec_equals(vec_2<real> lhs, vec_2<real> rhs) noexcept
+	{
+		return equals(lhs.x, rhs.x) && equals(lhs.y, rhs.y);
+	}
+
+	constexpr double square(double number) noexcept
+	{
+		return number * number;
+	}
+
+	constexpr float square(float number) noexcept
+	{
+		return number * number;
+	}
 }
\ No newline at end of file
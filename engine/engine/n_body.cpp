@@ -0,0 +1,346 @@
+#include "n_body.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace physics
+{
+	// Spreads the lower 16 bits of a number out to the even bits
+	uint32_t spread_bits(uint32_t number)
+	{
+		number &= 0x0000ffff;
+		number = (number | (number << 8)) & 0x00ff00ff;
+		number = (number | (number << 4)) & 0x0f0f0f0f;
+		number = (number | (number << 2)) & 0x33333333;
+		number = (number | (number << 1)) & 0x55555555;
+
+		return number;
+	}
+
+	// Acceleration towards a point mass divided by the gravitational constant
+	template <typename real>
+	physics::vec_2<real> get_point_acceleration(physics::vec_2<real> position, physics::vec_2<real> source, real mass, real softening_sq)
+	{
+		physics::vec_2<real> offset = vec_sub(source, position);
+		real distance_sq = vec_dot(offset, offset) + softening_sq;
+
+		if (distance_sq == 0)
+			return {};
+
+		real inv_distance = 1 / std::sqrt(distance_sq);
+
+		return vec_mul(offset, mass * inv_distance * inv_distance * inv_distance);
+	}
+
+	template <typename real>
+	void basic_n_body_gravity<real>::update_mass(std::vector<node>& tree, uint32_t node_index)
+	{
+		node& current = tree[node_index];
+		physics::vec_2<real> weighted_position {};
+		real mass = 0;
+
+		if (current.child_count == 0)
+		{
+			for (uint32_t i = current.begin; i < current.end; i++)
+			{
+				weighted_position = vec_add(weighted_position, vec_mul(positions[i], masses[i]));
+				mass += masses[i];
+			}
+		}
+		else
+		{
+			for (uint32_t i = current.first_child; i < current.first_child + current.child_count; i++)
+			{
+				weighted_position = vec_add(weighted_position, vec_mul(tree[i].center_of_mass, tree[i].mass));
+				mass += tree[i].mass;
+			}
+		}
+
+		current.mass = mass;
+		current.center_of_mass = mass > 0 ? vec_div(weighted_position, mass) : physics::vec_2<real> {};
+	}
+
+	template <typename real>
+	void basic_n_body_gravity<real>::build_node(std::vector<node>& tree, uint32_t node_index, uint32_t depth, uint32_t stop_depth)
+	{
+		uint32_t begin = tree[node_index].begin;
+		uint32_t end = tree[node_index].end;
+
+		if (end - begin <= leaf_capacity || depth == max_depth)
+		{
+			update_mass(tree, node_index);
+			return;
+		}
+
+		if (depth == stop_depth)
+		{
+			split_nodes.push_back(node_index);
+			return;
+		}
+
+		// The two key bits below the parent's select the quadrant
+		uint32_t shift = 62 - 2 * depth;
+		uint32_t first_child = static_cast<uint32_t>(tree.size());
+		uint32_t child_begin = begin;
+
+		for (uint64_t quadrant = 0; quadrant < 4; quadrant++)
+		{
+			uint32_t child_end = static_cast<uint32_t>(std::partition_point(sort_keys.begin() + child_begin, sort_keys.begin() + end, [&](uint64_t key) { return ((key >> shift) & 3) <= quadrant; }) - sort_keys.begin());
+
+			if (child_end > child_begin)
+			{
+				node child {};
+				child.size = tree[node_index].size / 2;
+				child.begin = child_begin;
+				child.end = child_end;
+				tree.push_back(child);
+			}
+
+			child_begin = child_end;
+		}
+
+		uint32_t child_count = static_cast<uint32_t>(tree.size()) - first_child;
+		tree[node_index].first_child = first_child;
+		tree[node_index].child_count = child_count;
+
+		for (uint32_t i = 0; i < child_count; i++)
+			build_node(tree, first_child + i, depth + 1, stop_depth);
+
+		// Children of nodes above stop_depth may still be split, their mass is summed once the subtrees are built
+		if (stop_depth == max_depth)
+			update_mass(tree, node_index);
+	}
+
+	template <typename real>
+	void basic_n_body_gravity<real>::build_tree(physics::thread_pool& thread_pool)
+	{
+		size_t body_count = slots.size();
+
+		physics::vec_2<real> min { std::numeric_limits<real>::max(), std::numeric_limits<real>::max() };
+		physics::vec_2<real> max { -std::numeric_limits<real>::max(), -std::numeric_limits<real>::max() };
+
+		for (physics::vec_2<real> position : positions)
+		{
+			min = { std::min(min.x, position.x), std::min(min.y, position.y) };
+			max = { std::max(max.x, position.x), std::max(max.y, position.y) };
+		}
+
+		real size = std::max(max.x - min.x, max.y - min.y);
+		real scale = size > 0 ? real(65535) / size : 0;
+
+		// Morton key in the upper half, so sorting keeps bodies with equal keys in storage order
+		sort_keys.resize(body_count);
+		for (size_t i = 0; i < body_count; i++)
+		{
+			uint32_t x = static_cast<uint32_t>(std::clamp((positions[i].x - min.x) * scale, real(0), real(65535)));
+			uint32_t y = static_cast<uint32_t>(std::clamp((positions[i].y - min.y) * scale, real(0), real(65535)));
+
+			sort_keys[i] = (static_cast<uint64_t>(spread_bits(x) | (spread_bits(y) << 1)) << 32) | i;
+		}
+
+		// Radix sort on the key half, 8 bits at a time
+		sort_buffer.resize(body_count);
+		for (uint32_t shift = 32; shift < 64; shift += 8)
+		{
+			size_t offsets[257] {};
+
+			for (uint64_t key : sort_keys)
+				offsets[((key >> shift) & 0xff) + 1]++;
+
+			for (size_t i = 1; i < 257; i++)
+				offsets[i] += offsets[i - 1];
+
+			for (uint64_t key : sort_keys)
+				sort_buffer[offsets[(key >> shift) & 0xff]++] = key;
+
+			sort_keys.swap(sort_buffer);
+		}
+
+		// Reorder the bodies along the curve, so bodies close in space are close in memory
+		slot_buffer.resize(body_count);
+		position_buffer.resize(body_count);
+		mass_buffer.resize(body_count);
+
+		for (size_t i = 0; i < body_count; i++)
+		{
+			uint32_t source = static_cast<uint32_t>(sort_keys[i]);
+			slot_buffer[i] = slots[source];
+			position_buffer[i] = positions[source];
+			mass_buffer[i] = masses[source];
+		}
+
+		slots.swap(slot_buffer);
+		positions.swap(position_buffer);
+		masses.swap(mass_buffer);
+
+		// Build the top of the tree, then the subtree below each node left to split in parallel
+		nodes.clear();
+		split_nodes.clear();
+
+		node root {};
+		root.size = size;
+		root.end = static_cast<uint32_t>(body_count);
+		nodes.push_back(root);
+
+		build_node(nodes, 0, 0, parallel_depth);
+		uint32_t top_count = static_cast<uint32_t>(nodes.size());
+
+		subtrees.resize(std::max(subtrees.size(), split_nodes.size()));
+
+		thread_pool.run(split_nodes.size(), [&](size_t task, size_t /*thread*/)
+		{
+			std::vector<node>& subtree = subtrees[task];
+			subtree.clear();
+			subtree.push_back(nodes[split_nodes[task]]);
+
+			build_node(subtree, 0, parallel_depth, max_depth);
+		});
+
+		// Append the subtrees, their child indices become offsets into the full tree
+		for (size_t task = 0; task < split_nodes.size(); task++)
+		{
+			const std::vector<node>& subtree = subtrees[task];
+			uint32_t offset = static_cast<uint32_t>(nodes.size()) - 1;
+
+			node& split_node = nodes[split_nodes[task]];
+			split_node = subtree[0];
+			split_node.first_child += offset;
+
+			for (size_t i = 1; i < subtree.size(); i++)
+			{
+				nodes.push_back(subtree[i]);
+
+				if (nodes.back().child_count > 0)
+					nodes.back().first_child += offset;
+			}
+		}
+
+		// Children of the top nodes come after them
+		for (uint32_t i = top_count; i-- > 0;)
+		{
+			if (nodes[i].child_count > 0)
+				update_mass(nodes, i);
+		}
+	}
+
+	template <typename real>
+	physics::vec_2<real> basic_n_body_gravity<real>::get_tree_acceleration(uint32_t body, real opening_angle_sq, real softening_sq) const
+	{
+		physics::vec_2<real> position = positions[body];
+		physics::vec_2<real> acceleration {};
+
+		// Each level leaves at most 3 unvisited children on the stack
+		uint32_t stack[4 * max_depth + 4];
+		size_t stack_size = 0;
+		stack[stack_size++] = 0;
+
+		while (stack_size > 0)
+		{
+			const node& current = nodes[stack[--stack_size]];
+
+			bool contains_body = body >= current.begin && body < current.end;
+			physics::vec_2<real> offset = vec_sub(current.center_of_mass, position);
+
+			// Far enough away to be treated as a single mass
+			if (!contains_body && current.size * current.size < opening_angle_sq * vec_dot(offset, offset))
+			{
+				acceleration = vec_add(acceleration, get_point_acceleration(position, current.center_of_mass, current.mass, softening_sq));
+			}
+			else if (current.child_count == 0)
+			{
+				for (uint32_t i = current.begin; i < current.end; i++)
+				{
+					if (i != body)
+						acceleration = vec_add(acceleration, get_point_acceleration(position, positions[i], masses[i], softening_sq));
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < current.child_count; i++)
+					stack[stack_size++] = current.first_child + i;
+			}
+		}
+
+		return acceleration;
+	}
+
+	template <typename real>
+	physics::vec_2<real> basic_n_body_gravity<real>::get_exact_acceleration(uint32_t body, real softening_sq) const
+	{
+		physics::vec_2<real> position = positions[body];
+		physics::vec_2<real> acceleration {};
+
+		for (uint32_t i = 0; i < positions.size(); i++)
+		{
+			if (i != body)
+				acceleration = vec_add(acceleration, get_point_acceleration(position, positions[i], masses[i], softening_sq));
+		}
+
+		return acceleration;
+	}
+
+	template <typename real>
+	void basic_n_body_gravity<real>::apply(physics::basic_body_storage<real>& storage, const physics::n_body_settings& settings, physics::thread_pool& thread_pool)
+	{
+		nodes.clear();
+
+		// Every dynamic body with mass attracts
+		slots.clear();
+		positions.clear();
+		masses.clear();
+
+		for (size_t i = 0; i < storage.size(); i++)
+		{
+			if (storage.inv_mass[i] == 0)
+				continue;
+
+			slots.push_back(static_cast<uint32_t>(i));
+			positions.push_back(storage.get_position(i));
+			masses.push_back(1 / storage.inv_mass[i]);
+		}
+
+		if (slots.size() < 2)
+			return;
+
+		bool barnes_hut = settings.mode == physics::n_body_mode::barnes_hut;
+
+		if (barnes_hut)
+			build_tree(thread_pool);
+
+		real opening_angle_sq = static_cast<real>(settings.opening_angle * settings.opening_angle);
+		real softening_sq = static_cast<real>(settings.softening * settings.softening);
+		size_t chunk_count = (slots.size() + force_chunk_size - 1) / force_chunk_size;
+
+		// Each body only writes its own force, so the result doesn't depend on the thread count
+		thread_pool.run(chunk_count, [&](size_t chunk, size_t /*thread*/)
+		{
+			uint32_t begin = static_cast<uint32_t>(chunk * force_chunk_size);
+			uint32_t end = static_cast<uint32_t>(std::min(begin + force_chunk_size, slots.size()));
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				uint32_t slot = slots[i];
+
+				// Sleeping bodies attract but aren't moved
+				if (storage.motion_mask[slot] == 0)
+					continue;
+
+				physics::vec_2<real> acceleration = barnes_hut ? get_tree_acceleration(i, opening_angle_sq, softening_sq) : get_exact_acceleration(i, softening_sq);
+				real factor = static_cast<real>(settings.gravitational_constant) * masses[i];
+
+				storage.force_x[slot] += acceleration.x * factor;
+				storage.force_y[slot] += acceleration.y * factor;
+			}
+		});
+	}
+
+	template <typename real>
+	size_t basic_n_body_gravity<real>::get_node_count() const
+	{
+		return nodes.size();
+	}
+
+	template class basic_n_body_gravity<float>;
+	template class basic_n_body_gravity<double>;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "body_storage.h"
+#include "thread_pool.h"
+
+namespace physics
+{
+	enum class n_body_mode
+	{
+		// Distant groups of bodies attract as a single mass, O(n log n)
+		barnes_hut,
+
+		// Every pair of bodies attracts directly, O(n^2), for validating the approximation
+		exact
+	};
+
+	struct n_body_settings
+	{
+		bool enabled { false };
+		physics::n_body_mode mode { physics::n_body_mode::barnes_hut };
+
+		double gravitational_constant { 6.674e-11 };
+
+		// A node of the quadtree is treated as a single mass once its width is less than this times its distance to the body
+		// Larger angles are faster but less accurate, 0 opens every node
+		double opening_angle { 0.5 };
+
+		// Length added to the distance between bodies, so close bodies don't receive huge forces
+		double softening { 0.0 };
+	};
+
+	// Newtonian gravity between every pair of dynamic bodies
+	// Bodies are sorted along a Morton curve and grouped into a quadtree whose subtrees are built and traversed in parallel
+	template <typename real>
+	class basic_n_body_gravity
+	{
+	private:
+		struct node
+		{
+			physics::vec_2<real> center_of_mass {};
+			real mass { 0 };
+
+			// Width of the node's square
+			real size { 0 };
+
+			// Bodies in the node, as a range of the sorted bodies
+			uint32_t begin { 0 };
+			uint32_t end { 0 };
+
+			// Children are stored next to each other, leaves have none
+			uint32_t first_child { 0 };
+			uint32_t child_count { 0 };
+		};
+
+		// Nodes with this many bodies or fewer are leaves, their bodies attract directly
+		static constexpr uint32_t leaf_capacity = 8;
+
+		// Morton keys hold 16 bits per axis, so the tree is at most this deep
+		static constexpr uint32_t max_depth = 16;
+
+		// Levels built on the calling thread, the subtrees below them are built in parallel
+		static constexpr uint32_t parallel_depth = 3;
+
+		// Number of bodies each traversal task finds the forces of
+		static constexpr size_t force_chunk_size = 256;
+
+		// Bodies with mass, as (Morton key << 32 | source index) while sorting
+		std::vector<uint64_t> sort_keys {};
+		std::vector<uint64_t> sort_buffer {};
+
+		// Storage slot, position and mass of each body with mass, sorted along the Morton curve in Barnes-Hut mode
+		std::vector<uint32_t> slots {};
+		std::vector<physics::vec_2<real>> positions {};
+		std::vector<real> masses {};
+
+		// Unsorted copies while reordering
+		std::vector<uint32_t> slot_buffer {};
+		std::vector<physics::vec_2<real>> position_buffer {};
+		std::vector<real> mass_buffer {};
+
+		std::vector<node> nodes {};
+
+		// Nodes at parallel_depth that still need to be split, and the subtree built below each of them
+		std::vector<uint32_t> split_nodes {};
+		std::vector<std::vector<node>> subtrees {};
+
+		// Splits a node into up to four children and recurses until stop_depth
+		// Nodes that would be split further are added to split_nodes
+		void build_node(std::vector<node>& tree, uint32_t node_index, uint32_t depth, uint32_t stop_depth);
+
+		// Sums the mass and center of mass of a node from its children or bodies
+		void update_mass(std::vector<node>& tree, uint32_t node_index);
+
+		void build_tree(physics::thread_pool& thread_pool);
+
+		// Gravitational acceleration on a sorted body divided by the gravitational constant
+		physics::vec_2<real> get_tree_acceleration(uint32_t body, real opening_angle_sq, real softening_sq) const;
+		physics::vec_2<real> get_exact_acceleration(uint32_t body, real softening_sq) const;
+
+	public:
+		// Adds the gravitational force on every awake dynamic body to its force for the current timestep
+		// Every dynamic body with mass attracts, including sleeping bodies
+		void apply(physics::basic_body_storage<real>& storage, const physics::n_body_settings& settings, physics::thread_pool& thread_pool);
+
+		// Number of quadtree nodes built by the last call to apply
+		size_t get_node_count() const;
+	};
+
+	using n_body_gravity = basic_n_body_gravity<double>;
+}
\ No newline at end of file
@@ -1,41 +1,50 @@
 #include "shape.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace physics
 {
-	shape::shape(physics::shape_type type)
+	template <typename real>
+	basic_shape<real>::basic_shape(physics::shape_type type)
 		: type(type)
 	{}
 
-	double shape::get_area() const
+	template <typename real>
+	real basic_shape<real>::get_area() const
 	{
 		return area;
 	}
 
-	double shape::get_area_of_inertia() const
+	template <typename real>
+	real basic_shape<real>::get_area_of_inertia() const
 	{
 		return area_of_inertia;
 	}
 
-	physics::vec_2d shape::get_centroid() const
+	template <typename real>
+	physics::vec_2<real> basic_shape<real>::get_centroid() const
 	{
 		return centroid;
 	}
 
-	shape_type shape::get_type() const
+	template <typename real>
+	shape_type basic_shape<real>::get_type() const
 	{
 		return type;
 	}
 
-	void polygon::calculate_shape()
+	// Calculates the area, centroid and "area of inertia" of a simple polygon
+	template <typename real>
+	void calculate_polygon_mass(std::span<const physics::vec_2<real>> vertices, real& area, physics::vec_2<real>& centroid, real& area_of_inertia)
 	{
 		// Calculates the area and centroid of a simple polygon 
 		// https://en.wikipedia.org/wiki/Polygon#Area_and_centroid
 		size_t n_vertices = vertices.size();
-		area = 0.0;
-		centroid = { 0.0, 0.0 };
-		area_of_inertia = 0.0;
+		area = 0;
+		centroid = { 0, 0 };
+		area_of_inertia = 0;
 
 		for (size_t i = 0; i < n_vertices - 1; i++)
 		{
@@ -45,13 +54,13 @@ namespace physics
 		}
 
 		area += vertices[n_vertices - 1].x * vertices[0].y - vertices[0].x * vertices[n_vertices - 1].y;
-		area *= 0.5;
+		area *= real(0.5);
 
 		centroid.x += (vertices[n_vertices - 1].x + vertices[0].x) * (vertices[n_vertices - 1].x * vertices[0].y - vertices[0].x * vertices[n_vertices - 1].y);
 		centroid.y += (vertices[n_vertices - 1].y + vertices[0].y) * (vertices[n_vertices - 1].x * vertices[0].y - vertices[0].x * vertices[n_vertices - 1].y);
 
-		centroid.x /= (6.0 * area);
-		centroid.y /= (6.0 * area);
+		centroid.x /= (real(6) * area);
+		centroid.y /= (real(6) * area);
 
 		area = std::abs(area);
 
@@ -61,72 +70,254 @@ namespace physics
 		// https://en.wikipedia.org/wiki/Parallel_axis_theorem
 		for (size_t i = 0; i < n_vertices; i++)
 		{
-			physics::vec_2d vertex_a = vertices[i];
-			physics::vec_2d vertex_b = vertices[i + 1 == n_vertices ? 0 : i + 1];
+			physics::vec_2<real> vertex_a = vertices[i];
+			physics::vec_2<real> vertex_b = vertices[i + 1 == n_vertices ? 0 : i + 1];
 
 			// (A * A + A * B + B * B) * cross(A, B)
 			area_of_inertia += std::abs(vec_cross(vertex_a, vertex_b) * (vec_dot(vertex_a, vertex_a) + vec_dot(vertex_b, vertex_b) + vec_dot(vertex_a, vertex_b)));
 		}
 
-		area_of_inertia /= 12.0;
+		area_of_inertia /= real(12);
 		area_of_inertia -= area * vec_dot(centroid, centroid); 
 	}
 
-	polygon::polygon()
-		: shape(physics::shape_type::polygon)
+	template <typename real>
+	void basic_polygon<real>::calculate_normals()
+	{
+		// Edge normals are normalized once here so collision tests don't need to
+		size_t n_vertices = vertices.size();
+		normals.resize(n_vertices);
+
+		for (size_t i = 0; i < n_vertices; i++)
+		{
+			physics::vec_2<real> edge = vec_sub(vertices[i + 1 == n_vertices ? 0 : i + 1], vertices[i]);
+			normals[i] = vec_normalize(physics::vec_2<real>(-edge.y, edge.x));
+		}
+	}
+
+	template <typename real>
+	void basic_polygon<real>::calculate_shape()
+	{
+		calculate_polygon_mass<real>(vertices, this->area, this->centroid, this->area_of_inertia);
+		calculate_normals();
+	}
+
+	template <typename real>
+	basic_polygon<real>::basic_polygon()
+		: basic_shape<real>(physics::shape_type::polygon)
 	{}
 
-	polygon::polygon(std::vector<physics::vec_2d> vertices)
-		: vertices(vertices), shape(physics::shape_type::polygon)
+	template <typename real>
+	basic_polygon<real>::basic_polygon(std::vector<physics::vec_2<real>> vertices)
+		: vertices(vertices), basic_shape<real>(physics::shape_type::polygon)
 	{
 		calculate_shape();
 	}
 
-	const std::vector<physics::vec_2d>& polygon::get_vertices() const
+	template <typename real>
+	basic_polygon<real>::basic_polygon(physics::shape_type type, std::vector<physics::vec_2<real>> vertices)
+		: vertices(vertices), basic_shape<real>(type)
+	{}
+
+	template <typename real>
+	const physics::basic_vertex_array<real>& basic_polygon<real>::get_vertices() const
 	{
 		return vertices;
 	}
 
-	void circle::calculate_shape()
+	template <typename real>
+	const physics::basic_vertex_array<real>& basic_polygon<real>::get_normals() const
 	{
-		area = physics::pi * radius * radius;
-		centroid = { 0, 0 };
-		area_of_inertia = 0.5 * radius * radius;
+		return normals;
 	}
 
-	circle::circle(double radius)
-		: radius(radius), shape(physics::shape_type::circle)
+	template <typename real>
+	void basic_rounded_polygon<real>::calculate_shape()
 	{
-		radius = std::max(radius, 0.0);
+		// The mass is calculated from a finely divided outline, the rounded corners make the exact integrals awkward
+		std::vector<physics::vec_2<real>> outline;
+		get_rounded_outline<real>(this->vertices, radius, 32, outline);
+
+		calculate_polygon_mass<real>(outline, this->area, this->centroid, this->area_of_inertia);
+		this->calculate_normals();
+	}
+
+	template <typename real>
+	basic_rounded_polygon<real>::basic_rounded_polygon(std::vector<physics::vec_2<real>> vertices, real radius)
+		: basic_polygon<real>(physics::shape_type::rounded_polygon, vertices), radius(std::max(radius, real(0)))
+	{
+		calculate_shape();
+	}
+
+	template <typename real>
+	real basic_rounded_polygon<real>::get_radius() const
+	{
+		return radius;
+	}
+
+	template <typename real>
+	void basic_circle<real>::calculate_shape()
+	{
+		this->area = static_cast<real>(physics::pi) * radius * radius;
+		this->centroid = { 0, 0 };
+		this->area_of_inertia = real(0.5) * radius * radius;
+	}
+
+	template <typename real>
+	basic_circle<real>::basic_circle(real radius)
+		: radius(radius), basic_shape<real>(physics::shape_type::circle)
+	{
+		radius = std::max(radius, real(0));
 		calculate_shape();
 	}
 
-	double circle::get_radius() const
+	template <typename real>
+	real basic_circle<real>::get_radius() const
 	{
 		return radius;
 	}
 
-	shape_ptr make_rect(double width, double height)
+	template <typename real>
+	basic_shape_ptr<real> make_rect(std::type_identity_t<real> width, std::type_identity_t<real> height)
+	{
+		real half_width = width / 2;
+		real half_height = height / 2;
+
+		return std::move(std::make_unique<basic_polygon<real>>(basic_polygon<real>{ {{-half_width, half_height}, {-half_width, -half_height}, {half_width, -half_height}, {half_width, half_height}} }));
+	}
+
+	template <typename real>
+	basic_shape_ptr<real> make_polygon(std::vector<physics::vec_2<real>> vertices)
 	{
-		return std::move(std::make_unique<polygon>(polygon{ {{-width / 2.0, height / 2.0}, {-width / 2.0, -height / 2.0}, {width / 2.0, -height / 2.0}, {width / 2.0, height / 2.0}} }));
+		return std::move(std::make_unique<basic_polygon<real>>(basic_polygon<real>{vertices}));
 	}
 
-	shape_ptr make_polygon(std::vector<physics::vec_2d> vertices)
+	template <typename real>
+	basic_shape_ptr<real> make_circle(std::type_identity_t<real> radius)
 	{
-		return std::move(std::make_unique<polygon>(polygon{vertices}));
+		return std::move(std::make_unique<basic_circle<real>>(basic_circle<real>{ radius }));
 	}
 
-	shape_ptr make_circle(double radius)
+	template <typename real>
+	basic_shape_ptr<real> make_capsule(std::type_identity_t<real> length, std::type_identity_t<real> radius)
 	{
-		return std::move(std::make_unique<circle>(circle{ radius }));
+		return std::move(std::make_unique<basic_rounded_polygon<real>>(basic_rounded_polygon<real>{ {{-length / 2, 0}, {length / 2, 0}}, radius }));
+	}
+
+	template <typename real>
+	basic_shape_ptr<real> make_rounded_rect(std::type_identity_t<real> width, std::type_identity_t<real> height, std::type_identity_t<real> radius)
+	{
+		// The inner rectangle is shrunk so the rounded shape keeps the given dimensions
+		radius = std::min(radius, std::min(width, height) / 2);
+		real half_width = width / 2 - radius;
+		real half_height = height / 2 - radius;
+
+		return std::move(std::make_unique<basic_rounded_polygon<real>>(basic_rounded_polygon<real>{ {{-half_width, half_height}, {-half_width, -half_height}, {half_width, -half_height}, {half_width, half_height}}, radius }));
 	}
 
-	void translate_vertices(std::vector<physics::vec_2d>& vertices, physics::vec_2d origin, double rotation, physics::vec_2d centroid)
+	template <typename real>
+	basic_shape_ptr<real> make_rounded_polygon(std::vector<physics::vec_2<real>> vertices, std::type_identity_t<real> radius)
 	{
-		for (physics::vec_2d& vertex : vertices)
+		return std::move(std::make_unique<basic_rounded_polygon<real>>(basic_rounded_polygon<real>{ vertices, radius }));
+	}
+
+	template <typename real>
+	void get_rounded_outline(std::type_identity_t<std::span<const physics::vec_2<real>>> vertices, std::type_identity_t<real> radius, size_t arc_segments, std::vector<physics::vec_2<real>>& outline)
+	{
+		outline.clear();
+
+		size_t n_vertices = vertices.size();
+		if (n_vertices == 0)
+			return;
+
+		arc_segments = std::max(arc_segments, size_t { 1 });
+
+		// Walk the vertices counter-clockwise so the right hand normal of every edge points outwards
+		real signed_area = 0;
+		for (size_t i = 0; i < n_vertices; i++)
+			signed_area += vec_cross(vertices[i], vertices[i + 1 == n_vertices ? 0 : i + 1]);
+
+		bool reversed = signed_area < 0;
+		auto get_vertex = [&](size_t i) { return vertices[reversed ? n_vertices - 1 - i : i]; };
+
+		for (size_t i = 0; i < n_vertices; i++)
 		{
-			vertex = physics::rotate_point({ vertex.x - centroid.x, vertex.y - centroid.y }, rotation);
+			physics::vec_2<real> previous = get_vertex((i + n_vertices - 1) % n_vertices);
+			physics::vec_2<real> current = get_vertex(i);
+			physics::vec_2<real> next = get_vertex((i + 1) % n_vertices);
+
+			physics::vec_2<real> edge_in = vec_sub(current, previous);
+			physics::vec_2<real> edge_out = vec_sub(next, current);
+
+			// Each corner is an arc between the outward normals of the edges meeting at it
+			// The outline gives the shape's mass, so it uses the trigonometry that is identical on every platform
+			double start_angle = physics::deterministic_atan2(-edge_in.x, edge_in.y);
+			double end_angle = physics::deterministic_atan2(-edge_out.x, edge_out.y);
+
+			if (n_vertices == 1)
+				end_angle = start_angle + 2.0 * physics::pi;
+			else if (end_angle < start_angle)
+				end_angle += 2.0 * physics::pi;
+
+			for (size_t segment = 0; segment <= arc_segments; segment++)
+			{
+				double angle = start_angle + (end_angle - start_angle) * segment / arc_segments;
+				outline.push_back({ current.x + radius * static_cast<real>(physics::deterministic_cos(angle)), current.y + radius * static_cast<real>(physics::deterministic_sin(angle)) });
+			}
+		}
+	}
+
+	template <typename real>
+	void translate_vertices(std::type_identity_t<std::span<physics::vec_2<real>>> vertices, physics::vec_2<real> origin, std::type_identity_t<real> rotation, physics::vec_2<real> centroid)
+	{
+		translate_vertices(vertices, origin, physics::make_rotation_matrix(rotation), centroid);
+	}
+
+	template <typename real>
+	void translate_vertices(std::type_identity_t<std::span<physics::vec_2<real>>> vertices, physics::vec_2<real> origin, const physics::basic_rotation_matrix<real>& rotation, physics::vec_2<real> centroid)
+	{
+		for (physics::vec_2<real>& vertex : vertices)
+		{
+			vertex = physics::rotate_point(physics::vec_2<real>(vertex.x - centroid.x, vertex.y - centroid.y), rotation);
 			vertex = { vertex.x + origin.x, vertex.y + origin.y };
 		}
 	}
+
+	template <typename real>
+	void rotate_normals(std::type_identity_t<std::span<physics::vec_2<real>>> normals, const physics::basic_rotation_matrix<real>& rotation)
+	{
+		for (physics::vec_2<real>& normal : normals)
+			normal = physics::rotate_point(normal, rotation);
+	}
+
+	// The engine is instantiated for float and double
+	template class basic_shape<float>;
+	template class basic_polygon<float>;
+	template class basic_rounded_polygon<float>;
+	template class basic_circle<float>;
+	template basic_shape_ptr<float> make_rect<float>(float, float);
+	template basic_shape_ptr<float> make_polygon<float>(std::vector<physics::vec_2<float>>);
+	template basic_shape_ptr<float> make_circle<float>(float);
+	template basic_shape_ptr<float> make_capsule<float>(float, float);
+	template basic_shape_ptr<float> make_rounded_rect<float>(float, float, float);
+	template basic_shape_ptr<float> make_rounded_polygon<float>(std::vector<physics::vec_2<float>>, float);
+	template void get_rounded_outline<float>(std::span<const physics::vec_2<float>>, float, size_t, std::vector<physics::vec_2<float>>&);
+	template void translate_vertices<float>(std::span<physics::vec_2<float>>, physics::vec_2<float>, float, physics::vec_2<float>);
+	template void translate_vertices<float>(std::span<physics::vec_2<float>>, physics::vec_2<float>, const basic_rotation_matrix<float>&, physics::vec_2<float>);
+	template void rotate_normals<float>(std::span<physics::vec_2<float>>, const basic_rotation_matrix<float>&);
+
+	template class basic_shape<double>;
+	template class basic_polygon<double>;
+	template class basic_rounded_polygon<double>;
+	template class basic_circle<double>;
+	template basic_shape_ptr<double> make_rect<double>(double, double);
+	template basic_shape_ptr<double> make_polygon<double>(std::vector<physics::vec_2<double>>);
+	template basic_shape_ptr<double> make_circle<double>(double);
+	template basic_shape_ptr<double> make_capsule<double>(double, double);
+	template basic_shape_ptr<double> make_rounded_rect<double>(double, double, double);
+	template basic_shape_ptr<double> make_rounded_polygon<double>(std::vector<physics::vec_2<double>>, double);
+	template void get_rounded_outline<double>(std::span<const physics::vec_2<double>>, double, size_t, std::vector<physics::vec_2<double>>&);
+	template void translate_vertices<double>(std::span<physics::vec_2<double>>, physics::vec_2<double>, double, physics::vec_2<double>);
+	template void translate_vertices<double>(std::span<physics::vec_2<double>>, physics::vec_2<double>, const basic_rotation_matrix<double>&, physics::vec_2<double>);
+	template void rotate_normals<double>(std::span<physics::vec_2<double>>, const basic_rotation_matrix<double>&);
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <span>
 #include <vector>
 #include <memory>
 #include "math.h"
+#include "vertex_array.h"
 
 namespace physics
 {
@@ -10,71 +12,137 @@ namespace physics
 	{
 		none,
 		polygon,
-		circle
+		circle,
+		rounded_polygon
 	};
 
-	class shape 
+	template <typename real>
+	class basic_shape
 	{
 	protected:
-		shape(physics::shape_type type);
+		basic_shape(physics::shape_type type);
 
-		double area { 0.0 };
-		double area_of_inertia { 0.0 };  
-		physics::vec_2d centroid { 0, 0 };
+		real area { 0 };
+		real area_of_inertia { 0 };
+		physics::vec_2<real> centroid { 0, 0 };
 		physics::shape_type type { physics::shape_type::none };
 
 		// Virtual function to calculate properties of the shape (area, inertia, centroid)
 		virtual void calculate_shape() = 0;
 
 	public:
-		~shape() = default;
+		~basic_shape() = default;
 
-		double get_area() const; 
-		double get_area_of_inertia() const;
-		physics::vec_2d get_centroid() const;
+		real get_area() const;
+		real get_area_of_inertia() const;
+		physics::vec_2<real> get_centroid() const;
 		physics::shape_type get_type() const;
 	};
 
-	using shape_ptr = std::unique_ptr<physics::shape>;
+	template <typename real>
+	using basic_shape_ptr = std::unique_ptr<physics::basic_shape<real>>;
 
 	// Arbitrary convex polygon class
-	class polygon : public shape
+	// Polygons with up to vertex_array::inline_capacity vertices store them inline, larger polygons allocate
+	template <typename real>
+	class basic_polygon : public basic_shape<real>
+	{
+	protected:
+		physics::basic_vertex_array<real> vertices {};
+
+		// Unit normal of the edge from each vertex to the next, in local space
+		physics::basic_vertex_array<real> normals {};
+
+		// Constructor for derived polygon types, which calculate the shape themselves
+		basic_polygon(physics::shape_type type, std::vector<physics::vec_2<real>> vertices);
+
+		void calculate_normals();
+		void calculate_shape();
+
+	public:
+		basic_polygon();
+		basic_polygon(std::vector<physics::vec_2<real>> vertices);
+
+		const physics::basic_vertex_array<real>& get_vertices() const;
+		const physics::basic_vertex_array<real>& get_normals() const;
+	};
+
+	// Convex polygon with every point within a radius of it included, which rounds its corners
+	// A rounded polygon of two vertices is a capsule
+	// Collisions are tested with GJK, which only needs the polygon's vertices and the radius
+	template <typename real>
+	class basic_rounded_polygon : public basic_polygon<real>
 	{
 	private:
-		std::vector<physics::vec_2d> vertices {};
+		real radius { 0 };
 
 		void calculate_shape();
 
 	public:
-		polygon();
-		polygon(std::vector<physics::vec_2d> vertices);
+		basic_rounded_polygon(std::vector<physics::vec_2<real>> vertices, real radius);
 
-		const std::vector<physics::vec_2d>& get_vertices() const;
+		real get_radius() const;
 	};
 
 	// Circle class
-	class circle : public shape
+	template <typename real>
+	class basic_circle : public basic_shape<real>
 	{
 	private:
-		double radius { 0.0 };
+		real radius { 0 };
 
 		void calculate_shape();
 
 	public:
-		circle(double radius);
+		basic_circle(real radius);
 
-		double get_radius() const;
+		real get_radius() const;
 	};
 
-	// Creates a rectangle of given dimensions centered locally around the point (0, 0) 
-	shape_ptr make_rect(double width, double height);
+	using shape = basic_shape<double>;
+	using shape_ptr = basic_shape_ptr<double>;
+	using polygon = basic_polygon<double>;
+	using rounded_polygon = basic_rounded_polygon<double>;
+	using circle = basic_circle<double>;
+
+	// Shapes are made in double precision unless another scalar type is given, e.g. make_rect<float>(1, 1)
+
+	// Creates a rectangle of given dimensions centered locally around the point (0, 0)
+	template <typename real = double>
+	basic_shape_ptr<real> make_rect(std::type_identity_t<real> width, std::type_identity_t<real> height);
 
 	// Creates a polygon with given vertices (in counter-clockwise order) around the point (0, 0)
-	shape_ptr make_polygon(std::vector<physics::vec_2d> vertices);
+	template <typename real = double>
+	basic_shape_ptr<real> make_polygon(std::vector<physics::vec_2<real>> vertices);
 
 	// Create a circle of given radius centered locally around the point (0, )
-	shape_ptr make_circle(double radius);
+	template <typename real = double>
+	basic_shape_ptr<real> make_circle(std::type_identity_t<real> radius);
+
+	// Creates a capsule along the x axis, length is the distance between the centers of its two end caps
+	template <typename real = double>
+	basic_shape_ptr<real> make_capsule(std::type_identity_t<real> length, std::type_identity_t<real> radius);
+
+	// Creates a rectangle of given outer dimensions with its corners rounded by a radius
+	template <typename real = double>
+	basic_shape_ptr<real> make_rounded_rect(std::type_identity_t<real> width, std::type_identity_t<real> height, std::type_identity_t<real> radius);
+
+	// Creates a polygon with given vertices (in counter-clockwise order) rounded by a radius
+	template <typename real = double>
+	basic_shape_ptr<real> make_rounded_polygon(std::vector<physics::vec_2<real>> vertices, std::type_identity_t<real> radius);
+
+	// Gets the outline of a polygon rounded by a radius, with each rounded corner approximated by arc_segments edges
+	template <typename real>
+	void get_rounded_outline(std::type_identity_t<std::span<const physics::vec_2<real>>> vertices, std::type_identity_t<real> radius, size_t arc_segments, std::vector<physics::vec_2<real>>& outline);
+
+	// Translates a set of vertices
+	template <typename real>
+	void translate_vertices(std::type_identity_t<std::span<physics::vec_2<real>>> vertices, physics::vec_2<real> origin, std::type_identity_t<real> rotation, physics::vec_2<real> centroid);
+
+	template <typename real>
+	void translate_vertices(std::type_identity_t<std::span<physics::vec_2<real>>> vertices, physics::vec_2<real> origin, const physics::basic_rotation_matrix<real>& rotation, physics::vec_2<real> centroid);
 
-	// Translates a set of vertices 
-	void translate_vertices(std::vector<physics::vec_2d>& vertices, physics::vec_2d origin, double rotation, physics::vec_2d centroid);
+	// Rotates a set of edge normals
+	template <typename real>
+	void rotate_normals(std::type_identity_t<std::span<physics::vec_2<real>>> normals, const physics::basic_rotation_matrix<real>& rotation);
 }
\ No newline at end of file
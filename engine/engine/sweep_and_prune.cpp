@@ -0,0 +1,137 @@
+#include "sweep_and_prune.h"
+#include <algorithm>
+
+namespace physics
+{
+	template <typename real>
+	void basic_sweep_and_prune<real>::sort_intervals()
+	{
+		auto compare = [](const interval& a, const interval& b) { return a.min_x < b.min_x; };
+
+		size_t new_count = unsorted_count;
+		unsorted_count = 0;
+
+		// New intervals can belong anywhere, so many of them make the insertion sort O(n^2)
+		if (new_count * new_interval_ratio > intervals.size())
+		{
+			std::sort(intervals.begin(), intervals.end(), compare);
+			return;
+		}
+
+		// Insertion sort, the intervals are almost sorted from the previous step
+		// If bodies moved far enough to make it expensive, the partly sorted intervals are sorted fully instead
+		size_t max_shifts = max_shifts_per_interval * intervals.size();
+		size_t shifts = 0;
+
+		for (size_t i = 1; i < intervals.size(); i++)
+		{
+			if (intervals[i - 1].min_x <= intervals[i].min_x)
+				continue;
+
+			interval current = intervals[i];
+			size_t j = i;
+
+			while (j > 0 && intervals[j - 1].min_x > current.min_x)
+			{
+				intervals[j] = intervals[j - 1];
+				j--;
+			}
+
+			intervals[j] = current;
+
+			shifts += i - j;
+			if (shifts > max_shifts)
+			{
+				std::sort(intervals.begin(), intervals.end(), compare);
+				return;
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_sweep_and_prune<real>::insert(physics::basic_body<real>* body)
+	{
+		// A body removed and inserted again before the next update keeps its interval
+		auto removed = std::find(removed_bodies.begin(), removed_bodies.end(), body);
+		if (removed != removed_bodies.end())
+		{
+			*removed = removed_bodies.back();
+			removed_bodies.pop_back();
+			return;
+		}
+
+		interval new_interval {};
+		new_interval.body = body;
+
+		// The new interval is sorted into place on the next update
+		intervals.push_back(new_interval);
+		unsorted_count++;
+	}
+
+	template <typename real>
+	void basic_sweep_and_prune<real>::remove(physics::basic_body<real>* body)
+	{
+		removed_bodies.push_back(body);
+	}
+
+	template <typename real>
+	void basic_sweep_and_prune<real>::clear()
+	{
+		intervals.clear();
+		removed_bodies.clear();
+		unsorted_count = 0;
+	}
+
+	template <typename real>
+	void basic_sweep_and_prune<real>::update()
+	{
+		// Erase (rather than swap) to keep the intervals sorted
+		if (!removed_bodies.empty())
+		{
+			std::sort(removed_bodies.begin(), removed_bodies.end());
+			std::erase_if(intervals, [this](const interval& interval) { return std::binary_search(removed_bodies.begin(), removed_bodies.end(), interval.body); });
+			removed_bodies.clear();
+		}
+
+		for (interval& interval : intervals)
+		{
+			physics::basic_aabb<real> aabb = interval.body->get_aabb();
+
+			interval.min_x = aabb.min.x;
+			interval.max_x = aabb.max.x;
+			interval.min_y = aabb.min.y;
+			interval.max_y = aabb.max.y;
+			interval.is_static = interval.body->get_type() == physics::static_body;
+		}
+
+		sort_intervals();
+	}
+
+	template <typename real>
+	void basic_sweep_and_prune<real>::find_pairs(std::vector<physics::basic_body_pair<real>>& pairs)
+	{
+		size_t count = intervals.size();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const interval& a = intervals[i];
+
+			// Every interval starting before a ends overlaps a on the x-axis
+			for (size_t j = i + 1; j < count && intervals[j].min_x <= a.max_x; j++)
+			{
+				const interval& b = intervals[j];
+
+				if (a.is_static && b.is_static)
+					continue;
+
+				if (a.min_y > b.max_y || a.max_y < b.min_y)
+					continue;
+
+				pairs.push_back(make_body_pair(a.body, b.body));
+			}
+		}
+	}
+
+	template class basic_sweep_and_prune<float>;
+	template class basic_sweep_and_prune<double>;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "broad_phase.h"
+
+namespace physics
+{
+	// Sweep and prune (sort and sweep) broad phase along the x-axis
+	// Body intervals are kept sorted between steps and re-sorted with an insertion sort,
+	// which is close to O(n) when bodies only move a small amount each step
+	// Bulk inserts and large moves fall back to a full O(n log n) sort
+	template <typename real>
+	class basic_sweep_and_prune : public basic_broad_phase<real>
+	{
+	private:
+		// Cached copy of a body's AABB, stored inline so the sweep reads memory linearly
+		struct interval
+		{
+			real min_x { 0 };
+			real max_x { 0 };
+			real min_y { 0 };
+			real max_y { 0 };
+
+			physics::basic_body<real>* body { nullptr };
+			bool is_static { false };
+		};
+
+		// Intervals sorted by min_x
+		std::vector<interval> intervals {};
+
+		// Intervals inserted since the last sort, appended unsorted in creation order
+		size_t unsorted_count { 0 };
+
+		// Bodies removed since the last update, their intervals are erased together in one pass
+		// Whole sleep groups are removed at once when they fall asleep, which would be O(n) per body otherwise
+		std::vector<physics::basic_body<real>*> removed_bodies {};
+
+		// Fully sort when more than 1 / new_interval_ratio of the intervals are new
+		static constexpr size_t new_interval_ratio = 8;
+
+		// Fully sort when the insertion sort shifts more than this many times the interval count
+		static constexpr size_t max_shifts_per_interval = 8;
+
+		void sort_intervals();
+
+	public:
+		void insert(physics::basic_body<real>* body) override;
+		void remove(physics::basic_body<real>* body) override;
+		void clear() override;
+		void update() override;
+		void find_pairs(std::vector<physics::basic_body_pair<real>>& pairs) override;
+	};
+
+	using sweep_and_prune = basic_sweep_and_prune<double>;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace physics
+{
+	thread_pool::thread_pool(size_t thread_count)
+	{
+		start_workers(thread_count);
+	}
+
+	thread_pool::~thread_pool()
+	{
+		stop_workers();
+	}
+
+	void thread_pool::start_workers(size_t thread_count)
+	{
+		if (thread_count == 0)
+			thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+		stopping = false;
+
+		// The calling thread is thread 0
+		for (size_t i = 1; i < thread_count; i++)
+			workers.emplace_back(&thread_pool::worker_loop, this, i, generation);
+	}
+
+	void thread_pool::stop_workers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+
+		start_condition.notify_all();
+
+		for (std::thread& worker : workers)
+			worker.join();
+
+		workers.clear();
+	}
+
+	void thread_pool::worker_loop(size_t thread_index, uint64_t last_generation)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				start_condition.wait(lock, [&] { return stopping || generation != last_generation; });
+
+				if (stopping)
+					return;
+
+				last_generation = generation;
+			}
+
+			run_tasks(thread_index);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				busy_workers--;
+			}
+
+			done_condition.notify_one();
+		}
+	}
+
+	void thread_pool::run_tasks(size_t thread_index)
+	{
+		// Threads claim tasks until none are left
+		for (size_t index = next_task++; index < task_count; index = next_task++)
+			(*task)(index, thread_index);
+	}
+
+	void thread_pool::set_thread_count(size_t thread_count)
+	{
+		stop_workers();
+		start_workers(thread_count);
+	}
+
+	size_t thread_pool::get_thread_count() const
+	{
+		return workers.size() + 1;
+	}
+
+	void thread_pool::run(size_t task_count, physics::task_ref task)
+	{
+		// Not worth waking the workers
+		if (workers.empty() || task_count <= 1)
+		{
+			for (size_t index = 0; index < task_count; index++)
+				task(index, 0);
+
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			this->task = &task;
+			this->task_count = task_count;
+			next_task = 0;
+			busy_workers = workers.size();
+			generation++;
+		}
+
+		start_condition.notify_all();
+
+		run_tasks(0);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done_condition.wait(lock, [&] { return busy_workers == 0; });
+
+		this->task = nullptr;
+	}
+}
\ No newline at end of file
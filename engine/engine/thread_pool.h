@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace physics
+{
+	// Non-owning reference to a callable taking (task index, thread index)
+	// Unlike std::function it never allocates, the callable must outlive the reference
+	class task_ref
+	{
+	private:
+		const void* callable { nullptr };
+		void (*invoke)(const void*, size_t, size_t) { nullptr };
+
+	public:
+		template <typename function_type>
+		task_ref(const function_type& function)
+			: callable(&function),
+			invoke([](const void* callable, size_t task, size_t thread) { (*static_cast<const function_type*>(callable))(task, thread); })
+		{}
+
+		void operator()(size_t task, size_t thread) const
+		{
+			invoke(callable, task, thread);
+		}
+	};
+
+	// Pool of worker threads that run batches of tasks
+	// The calling thread works on the batch as well, so a pool with a thread count of 1 runs everything inline
+	class thread_pool
+	{
+	private:
+		std::vector<std::thread> workers {};
+
+		std::mutex mutex {};
+		std::condition_variable start_condition {};
+		std::condition_variable done_condition {};
+
+		// Current batch (task index, thread index)
+		const physics::task_ref* task { nullptr };
+		size_t task_count { 0 };
+		std::atomic<size_t> next_task { 0 };
+
+		// Workers still running the current batch
+		size_t busy_workers { 0 };
+
+		// Incremented for each batch so workers can tell a new batch has started
+		uint64_t generation { 0 };
+		bool stopping { false };
+
+		// Workers start with the generation at the time they are created so they only run later batches
+		void worker_loop(size_t thread_index, uint64_t last_generation);
+		void run_tasks(size_t thread_index);
+
+		void start_workers(size_t thread_count);
+		void stop_workers();
+
+	public:
+		thread_pool(size_t thread_count = 0);
+		~thread_pool();
+		thread_pool(thread_pool const&) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		// Set the number of threads including the calling thread (0 to use every hardware thread)
+		void set_thread_count(size_t thread_count);
+		size_t get_thread_count() const;
+
+		// Runs task(task_index, thread_index) for every task index in [0, task_count) and waits for all of them to finish
+		// Thread indices are in [0, get_thread_count()), with 0 being the calling thread
+		void run(size_t task_count, physics::task_ref task);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include "uniform_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace physics
+{
+	// Packs a cell coordinate into a hash map key
+	uint64_t get_cell_key(int32_t x, int32_t y)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+	}
+
+	template <typename real>
+	bool basic_uniform_grid<real>::cell_range::operator==(const cell_range& other) const
+	{
+		return min_x == other.min_x && min_y == other.min_y && max_x == other.max_x && max_y == other.max_y;
+	}
+
+	template <typename real>
+	int64_t basic_uniform_grid<real>::cell_range::get_cell_count() const
+	{
+		return (static_cast<int64_t>(max_x) - min_x + 1) * (static_cast<int64_t>(max_y) - min_y + 1);
+	}
+
+	template <typename real>
+	basic_uniform_grid<real>::basic_uniform_grid(real cell_size)
+		: requested_cell_size(cell_size)
+	{}
+
+	template <typename real>
+	int32_t basic_uniform_grid<real>::get_cell(real coordinate) const
+	{
+		// Clamp to avoid overflow for bodies far away from the origin
+		real cell = std::floor(coordinate / cell_size);
+		cell = std::clamp(cell, static_cast<real>(INT32_MIN / 2), static_cast<real>(INT32_MAX / 2));
+
+		return static_cast<int32_t>(cell);
+	}
+
+	template <typename real>
+	typename basic_uniform_grid<real>::cell_range basic_uniform_grid<real>::get_cell_range(const physics::basic_aabb<real>& aabb) const
+	{
+		return { get_cell(aabb.min.x), get_cell(aabb.min.y), get_cell(aabb.max.x), get_cell(aabb.max.y) };
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::add_to_cells(uint32_t proxy_index, const cell_range& range)
+	{
+		if (range.get_cell_count() > max_cells_per_body)
+		{
+			oversized_proxies.push_back(proxy_index);
+			return;
+		}
+
+		for (int32_t x = range.min_x; x <= range.max_x; x++)
+		{
+			for (int32_t y = range.min_y; y <= range.max_y; y++)
+			{
+				uint64_t key = get_cell_key(x, y);
+				auto it = cells.find(key);
+
+				if (it == cells.end() && !free_cells.empty())
+				{
+					cell_map::node_type node = std::move(free_cells.back());
+					free_cells.pop_back();
+
+					node.key() = key;
+					it = cells.insert(std::move(node)).position;
+				}
+				else if (it == cells.end())
+				{
+					it = cells.emplace(key, std::vector<uint32_t> {}).first;
+				}
+
+				it->second.push_back(proxy_index);
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::remove_from_cells(uint32_t proxy_index, const cell_range& range)
+	{
+		if (range.get_cell_count() > max_cells_per_body)
+		{
+			auto it = std::find(oversized_proxies.begin(), oversized_proxies.end(), proxy_index);
+
+			if (it != oversized_proxies.end())
+			{
+				*it = oversized_proxies.back();
+				oversized_proxies.pop_back();
+			}
+
+			return;
+		}
+
+		for (int32_t x = range.min_x; x <= range.max_x; x++)
+		{
+			for (int32_t y = range.min_y; y <= range.max_y; y++)
+			{
+				auto it = cells.find(get_cell_key(x, y));
+				if (it == cells.end())
+					continue;
+
+				std::vector<uint32_t>& cell = it->second;
+				auto proxy_it = std::find(cell.begin(), cell.end(), proxy_index);
+
+				if (proxy_it != cell.end())
+				{
+					*proxy_it = cell.back();
+					cell.pop_back();
+				}
+
+				if (cell.empty())
+					free_cells.push_back(cells.extract(it));
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::tune_cell_size()
+	{
+		tuned_body_count = proxies.size();
+
+		if (requested_cell_size > 0)
+		{
+			cell_size = requested_cell_size;
+			return;
+		}
+
+		if (proxies.empty())
+			return;
+
+		std::vector<real> extents;
+		extents.reserve(proxies.size());
+
+		for (const proxy& proxy : proxies)
+		{
+			physics::basic_aabb<real> aabb = proxy.body->get_aabb();
+			extents.push_back(std::max(aabb.max.x - aabb.min.x, aabb.max.y - aabb.min.y));
+		}
+
+		auto median = extents.begin() + extents.size() / 2;
+		std::nth_element(extents.begin(), median, extents.end());
+
+		// Cells twice the size of a typical body keep most bodies within 1-4 cells
+		if (*median > 0)
+			cell_size = *median * 2;
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::rebuild()
+	{
+		tune_cell_size();
+		cells.clear();
+		free_cells.clear();
+		oversized_proxies.clear();
+
+		for (uint32_t i = 0; i < proxies.size(); i++)
+		{
+			proxies[i].range = get_cell_range(proxies[i].body->get_aabb());
+			add_to_cells(i, proxies[i].range);
+		}
+
+		needs_rebuild = false;
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::insert(physics::basic_body<real>* body)
+	{
+		proxy new_proxy {};
+		new_proxy.body = body;
+		new_proxy.is_static = body->get_type() == physics::static_body;
+
+		uint32_t proxy_index = static_cast<uint32_t>(proxies.size());
+		proxy_lookup[body->get_id()] = proxy_index;
+
+		// Cells are filled on the next rebuild if the grid is not built yet
+		if (!needs_rebuild)
+		{
+			new_proxy.range = get_cell_range(body->get_aabb());
+			add_to_cells(proxy_index, new_proxy.range);
+		}
+
+		proxies.push_back(new_proxy);
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::remove(physics::basic_body<real>* body)
+	{
+		auto it = proxy_lookup.find(body->get_id());
+		if (it == proxy_lookup.end())
+			return;
+
+		uint32_t proxy_index = it->second;
+		uint32_t last_index = static_cast<uint32_t>(proxies.size() - 1);
+		proxy_lookup.erase(it);
+
+		if (!needs_rebuild)
+			remove_from_cells(proxy_index, proxies[proxy_index].range);
+
+		// Swap the last proxy into the removed slot
+		if (proxy_index != last_index)
+		{
+			if (!needs_rebuild)
+			{
+				remove_from_cells(last_index, proxies[last_index].range);
+				add_to_cells(proxy_index, proxies[last_index].range);
+			}
+
+			proxies[proxy_index] = proxies[last_index];
+			proxy_lookup[proxies[proxy_index].body->get_id()] = proxy_index;
+		}
+
+		proxies.pop_back();
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::clear()
+	{
+		proxies.clear();
+		proxy_lookup.clear();
+		cells.clear();
+		free_cells.clear();
+		oversized_proxies.clear();
+		tuned_body_count = 0;
+		needs_rebuild = true;
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::update()
+	{
+		// Retune the cell size when the number of bodies changes significantly
+		if (proxies.size() > tuned_body_count * 2 || proxies.size() < tuned_body_count / 2)
+			needs_rebuild = true;
+
+		if (needs_rebuild)
+		{
+			rebuild();
+			return;
+		}
+
+		for (uint32_t i = 0; i < proxies.size(); i++)
+		{
+			proxy& proxy = proxies[i];
+
+			if (proxy.is_static != (proxy.body->get_type() == physics::static_body))
+				proxy.is_static = !proxy.is_static;
+
+			cell_range range = get_cell_range(proxy.body->get_aabb());
+
+			// Only re-bin bodies that moved into different cells
+			if (range == proxy.range)
+				continue;
+
+			remove_from_cells(i, proxy.range);
+			add_to_cells(i, range);
+			proxy.range = range;
+		}
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::find_pairs(std::vector<physics::basic_body_pair<real>>& pairs)
+	{
+		for (const auto& [key, cell] : cells)
+		{
+			if (cell.size() < 2)
+				continue;
+
+			int32_t cell_x = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+			int32_t cell_y = static_cast<int32_t>(static_cast<uint32_t>(key));
+
+			for (size_t i = 0; i < cell.size() - 1; i++)
+			{
+				const proxy& proxy_a = proxies[cell[i]];
+				physics::basic_aabb<real> aabb_a = proxy_a.body->get_aabb();
+
+				for (size_t j = i + 1; j < cell.size(); j++)
+				{
+					const proxy& proxy_b = proxies[cell[j]];
+
+					if (proxy_a.is_static && proxy_b.is_static)
+						continue;
+
+					physics::basic_aabb<real> aabb_b = proxy_b.body->get_aabb();
+
+					if (!physics::aabb_intersection(aabb_a, aabb_b))
+						continue;
+
+					// Bodies sharing several cells are only reported by the cell containing the
+					// minimum corner of their overlap, so each pair is found exactly once
+					if (get_cell(std::max(aabb_a.min.x, aabb_b.min.x)) != cell_x || get_cell(std::max(aabb_a.min.y, aabb_b.min.y)) != cell_y)
+						continue;
+
+					pairs.push_back(make_body_pair(proxy_a.body, proxy_b.body));
+				}
+			}
+		}
+
+		// Oversized proxies are in no cell, so they are tested against every proxy
+		// Pairs of two oversized proxies are reported by the one with the higher index
+		for (uint32_t oversized_index : oversized_proxies)
+		{
+			const proxy& proxy_a = proxies[oversized_index];
+			physics::basic_aabb<real> aabb_a = proxy_a.body->get_aabb();
+
+			for (uint32_t i = 0; i < proxies.size(); i++)
+			{
+				const proxy& proxy_b = proxies[i];
+
+				if (i == oversized_index || (proxy_a.is_static && proxy_b.is_static))
+					continue;
+
+				if (i > oversized_index && proxy_b.range.get_cell_count() > max_cells_per_body)
+					continue;
+
+				if (!physics::aabb_intersection(aabb_a, proxy_b.body->get_aabb()))
+					continue;
+
+				pairs.push_back(make_body_pair(proxy_a.body, proxy_b.body));
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_uniform_grid<real>::set_cell_size(real size)
+	{
+		requested_cell_size = std::max(size, real(0));
+		needs_rebuild = true;
+	}
+
+	template <typename real>
+	real basic_uniform_grid<real>::get_cell_size() const
+	{
+		return cell_size;
+	}
+
+	template class basic_uniform_grid<float>;
+	template class basic_uniform_grid<double>;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include "broad_phase.h"
+
+namespace physics
+{
+	// Spatial hash broad phase
+	// Bodies are binned into square cells by their AABB and only bodies sharing a cell are tested
+	// Bodies are only re-binned when their AABB moves into a different set of cells
+	// Bodies covering too many cells are kept out of the grid and tested against every other body
+	template <typename real>
+	class basic_uniform_grid : public basic_broad_phase<real>
+	{
+	private:
+		// Inclusive range of cells covered by an AABB
+		struct cell_range
+		{
+			int32_t min_x { 0 };
+			int32_t min_y { 0 };
+			int32_t max_x { -1 };
+			int32_t max_y { -1 };
+
+			bool operator == (const cell_range& other) const;
+
+			// Number of cells in the range (64-bit, a range can span most of the int32 grid)
+			int64_t get_cell_count() const;
+		};
+
+		struct proxy
+		{
+			physics::basic_body<real>* body { nullptr };
+			cell_range range {};
+			bool is_static { false };
+		};
+
+		std::vector<proxy> proxies {};
+
+		// Body id -> index into proxies
+		std::unordered_map<size_t, uint32_t> proxy_lookup {};
+
+		// Cell key -> indices of proxies overlapping the cell
+		using cell_map = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+		cell_map cells {};
+
+		// Nodes of cells that became empty, reused for new cells so bodies moving between cells don't allocate
+		std::vector<cell_map::node_type> free_cells {};
+
+		// Bodies whose AABB covers more than this many cells (a long platform or a huge body) are not binned
+		static constexpr int64_t max_cells_per_body = 64;
+
+		// Indices of proxies over the cell limit, tested against every proxy in find_pairs
+		std::vector<uint32_t> oversized_proxies {};
+
+		// Cell size set by the user (0 to tune automatically)
+		real requested_cell_size { 0 };
+
+		// Cell size currently used by the grid
+		real cell_size { 1 };
+
+		// Body count when the cell size was last tuned
+		size_t tuned_body_count { 0 };
+
+		bool needs_rebuild { true };
+
+		int32_t get_cell(real coordinate) const;
+		cell_range get_cell_range(const physics::basic_aabb<real>& aabb) const;
+
+		// Bins a proxy into the cells of a range, or into the oversized list if the range is over the cell limit
+		void add_to_cells(uint32_t proxy_index, const cell_range& range);
+		void remove_from_cells(uint32_t proxy_index, const cell_range& range);
+
+		// Picks the cell size from the median body AABB extent
+		void tune_cell_size();
+		void rebuild();
+
+	public:
+		basic_uniform_grid() = default;
+		basic_uniform_grid(real cell_size);
+
+		void insert(physics::basic_body<real>* body) override;
+		void remove(physics::basic_body<real>* body) override;
+		void clear() override;
+		void update() override;
+		void find_pairs(std::vector<physics::basic_body_pair<real>>& pairs) override;
+
+		// Set the cell size in world units (0 to tune automatically from the median AABB extent)
+		void set_cell_size(real size);
+		real get_cell_size() const;
+	};
+
+	using uniform_grid = basic_uniform_grid<double>;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "vertex_array.h"
+#include <algorithm>
+
+namespace physics
+{
+	template <typename real>
+	basic_vertex_array<real>::basic_vertex_array(std::span<const physics::vec_2<real>> vertices)
+	{
+		assign(vertices);
+	}
+
+	template <typename real>
+	void basic_vertex_array<real>::assign(std::span<const physics::vec_2<real>> vertices)
+	{
+		resize(vertices.size());
+		std::copy(vertices.begin(), vertices.end(), data());
+	}
+
+	template <typename real>
+	void basic_vertex_array<real>::resize(size_t size)
+	{
+		if (size <= inline_capacity)
+		{
+			// Move back inline if the polygon shrank
+			if (!is_inline())
+				std::copy(heap_vertices.begin(), heap_vertices.begin() + size, inline_vertices);
+
+			std::fill(inline_vertices + std::min(count, size), inline_vertices + inline_capacity, physics::vec_2<real> {});
+			heap_vertices.clear();
+		}
+		else
+		{
+			if (is_inline())
+				heap_vertices.assign(inline_vertices, inline_vertices + count);
+
+			heap_vertices.resize(size);
+		}
+
+		count = size;
+	}
+
+	template <typename real>
+	void basic_vertex_array<real>::clear()
+	{
+		resize(0);
+	}
+
+	template <typename real>
+	size_t basic_vertex_array<real>::size() const
+	{
+		return count;
+	}
+
+	template <typename real>
+	bool basic_vertex_array<real>::empty() const
+	{
+		return count == 0;
+	}
+
+	template <typename real>
+	bool basic_vertex_array<real>::is_inline() const
+	{
+		return count <= inline_capacity;
+	}
+
+	template <typename real>
+	physics::vec_2<real>* basic_vertex_array<real>::data()
+	{
+		return is_inline() ? inline_vertices : heap_vertices.data();
+	}
+
+	template <typename real>
+	const physics::vec_2<real>* basic_vertex_array<real>::data() const
+	{
+		return is_inline() ? inline_vertices : heap_vertices.data();
+	}
+
+	template <typename real>
+	physics::vec_2<real>& basic_vertex_array<real>::operator[](size_t index)
+	{
+		return data()[index];
+	}
+
+	template <typename real>
+	const physics::vec_2<real>& basic_vertex_array<real>::operator[](size_t index) const
+	{
+		return data()[index];
+	}
+
+	template <typename real>
+	physics::vec_2<real>* basic_vertex_array<real>::begin()
+	{
+		return data();
+	}
+
+	template <typename real>
+	physics::vec_2<real>* basic_vertex_array<real>::end()
+	{
+		return data() + count;
+	}
+
+	template <typename real>
+	const physics::vec_2<real>* basic_vertex_array<real>::begin() const
+	{
+		return data();
+	}
+
+	template <typename real>
+	const physics::vec_2<real>* basic_vertex_array<real>::end() const
+	{
+		return data() + count;
+	}
+
+	template class basic_vertex_array<float>;
+	template class basic_vertex_array<double>;
+}
\ No newline at end of file
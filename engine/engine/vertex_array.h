@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "math.h"
+
+namespace physics
+{
+	// Vertices of a polygon, stored inline so copying a polygon or a body doesn't allocate
+	// Polygons with more than inline_capacity vertices fall back to heap storage, which behaves the same but is slower to copy
+	template <typename real>
+	class basic_vertex_array
+	{
+	public:
+		static constexpr size_t inline_capacity = 8;
+
+	private:
+		physics::vec_2<real> inline_vertices[inline_capacity] {};
+
+		// Only used by polygons with more than inline_capacity vertices
+		std::vector<physics::vec_2<real>> heap_vertices {};
+
+		size_t count { 0 };
+
+	public:
+		basic_vertex_array() = default;
+		basic_vertex_array(std::span<const physics::vec_2<real>> vertices);
+
+		// Replace the vertices, reusing the current storage when possible
+		void assign(std::span<const physics::vec_2<real>> vertices);
+
+		// Set the number of vertices, new vertices are zeroed
+		void resize(size_t size);
+
+		void clear();
+
+		size_t size() const;
+		bool empty() const;
+
+		// Returns true if the vertices are stored inline
+		bool is_inline() const;
+
+		physics::vec_2<real>* data();
+		const physics::vec_2<real>* data() const;
+
+		physics::vec_2<real>& operator[](size_t index);
+		const physics::vec_2<real>& operator[](size_t index) const;
+
+		physics::vec_2<real>* begin();
+		physics::vec_2<real>* end();
+		const physics::vec_2<real>* begin() const;
+		const physics::vec_2<real>* end() const;
+	};
+
+	using vertex_array = basic_vertex_array<double>;
+}
\ No newline at end of file
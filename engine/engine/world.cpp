@@ -1,292 +1,936 @@
 #include "world.h"
+#include "uniform_grid.h"
+#include "sweep_and_prune.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <bit>
+#include <cstring>
 
 namespace physics
 {
-	world::world(physics::vec_2d gravity)
+	template <typename real>
+	basic_world<real>::basic_world()
+	{
+		rebuild_broad_phase();
+	}
+
+	template <typename real>
+	basic_world<real>::basic_world(physics::vec_2<real> gravity)
 		: gravity(gravity)
-	{}
+	{
+		rebuild_broad_phase();
+	}
+
+	template <typename real>
+	void basic_world<real>::rebuild_broad_phase()
+	{
+		switch (broad_phase_type)
+		{
+		case physics::broad_phase_type::uniform_grid:
+			broad_phase = std::make_unique<physics::basic_uniform_grid<real>>(grid_cell_size);
+			break;
+		case physics::broad_phase_type::dynamic_tree:
+			broad_phase = std::make_unique<physics::basic_dynamic_tree<real>>();
+			break;
+		case physics::broad_phase_type::sweep_and_prune:
+			broad_phase = std::make_unique<physics::basic_sweep_and_prune<real>>();
+			break;
+		default:
+			broad_phase = std::make_unique<physics::basic_brute_force_broad_phase<real>>();
+			break;
+		}
+
+		// Sleeping bodies stay in the sleeping tree
+		for (physics::basic_body<real>& body : bodies)
+		{
+			if (body.type == physics::dynamic_body && !storage.is_sleeping(body.index))
+				broad_phase->insert(&body);
+		}
+	}
+
+	template <typename real>
+	void basic_world<real>::rebuild_static_tree()
+	{
+		static_tree.clear();
+
+		for (physics::basic_body<real>& body : bodies)
+		{
+			if (body.type == physics::static_body)
+				static_tree.insert(&body);
+		}
 
-	std::vector<physics::collision_manifold> world::get_contacts() const
+		static_tree_changed = false;
+	}
+
+	template <typename real>
+	void basic_world<real>::on_body_changed(const physics::basic_aabb<real>& old_aabb, const physics::basic_aabb<real>& new_aabb, bool type_changed)
+	{
+		// Bodies moving between the static tree and the broad phase
+		if (type_changed)
+			rebuild_broad_phase();
+
+		static_tree_changed = true;
+
+		// Bodies resting where the body was should fall, and bodies where it is now should be pushed out
+		wake_overlapping(old_aabb);
+		wake_overlapping(new_aabb);
+	}
+
+	template <typename real>
+	std::vector<physics::basic_collision_manifold<real>> basic_world<real>::get_contacts() const
 	{
 		return contacts;
 	}
 
-	size_t world::get_body_count() const
+	template <typename real>
+	const std::vector<physics::basic_contact_event<real>>& basic_world<real>::get_contact_events() const
+	{
+		return contact_events;
+	}
+
+	template <typename real>
+	size_t basic_world<real>::get_body_count() const
 	{
 		return bodies.size();
 	}
 
-	std::vector<physics::body*> world::get_body_ptrs()
+	template <typename real>
+	std::vector<physics::basic_body<real>*> basic_world<real>::get_body_ptrs()
 	{
-		std::vector<physics::body*> body_ptrs;
+		std::vector<physics::basic_body<real>*> body_ptrs;
 
-		for (physics::body& body : bodies)
+		for (physics::basic_body<real>& body : bodies)
 			body_ptrs.push_back(&body);
 
 		return body_ptrs;
 	}
 
-	physics::body* world::create_body(shape_ptr shape, physics::material material, physics::body_type type, physics::vec_2d position, double rotation)
+	template <typename real>
+	physics::basic_body<real>* basic_world<real>::create_body(physics::basic_shape_ptr<real> shape, physics::basic_material<real> material, physics::body_type type, physics::vec_2<real> position, real rotation)
 	{
-		physics::body body(std::move(shape), material, type, position, rotation);
+		size_t index = storage.add();
+
+		physics::basic_body<real> body(this, index, std::move(shape), material, type, position, rotation);
 		body.id = body_id++;
 
 		bodies.push_back(std::move(body));
+		storage.bodies[index] = &bodies.back();
 
-		if (!bodies.empty())
-			return &bodies.back();
-			
-		return nullptr;
+		if (type == physics::static_body)
+		{
+			static_tree_changed = true;
+			wake_overlapping(storage.aabb[index]);
+		}
+		else
+		{
+			broad_phase->insert(&bodies.back());
+		}
+
+		return &bodies.back();
 	}
 
-	void world::remove_body(physics::body* body)
+	template <typename real>
+	void basic_world<real>::remove_body(physics::basic_body<real>* body)
 	{
 		auto it = std::find(bodies.begin(), bodies.end(), *body);
 		if (it != bodies.end())
+		{
+			// Bodies resting on the removed body should fall
+			// This wakes the body too, so a removed dynamic body is always in the broad phase rather than the sleeping tree
+			wake_overlapping(storage.aabb[body->index]);
+
+			if (body->type == physics::static_body)
+				static_tree_changed = true;
+			else
+				broad_phase->remove(body);
+
+			contact_cache.remove_body(body);
+			force_generators.remove_body(body);
+			storage.remove(body->index);
 			bodies.erase(it);
+		}
 	}
 
-	void world::clear()
+	template <typename real>
+	void basic_world<real>::clear()
 	{
 		bodies.clear();
+		storage.clear();
+		contacts.clear();
+		contact_cache.clear();
+		contact_events.clear();
+		broad_phase->clear();
+		static_tree.clear();
+		static_tree_changed = false;
+		sleeping_tree.clear();
+		force_generators.clear();
+
+		// Reset the per-world counters too, so a cleared world steps and hashes like a new one
+		sleep_group_count = 0;
+		woken_groups.clear();
+		state_hash = 0;
+		body_id = 0;
+	}
+
+	template <typename real>
+	size_t basic_world<real>::add_force(const physics::basic_uniform_force<real>& force)
+	{
+		wake_all();
+
+		return force_generators.add(force);
+	}
+
+	template <typename real>
+	size_t basic_world<real>::add_force(const physics::basic_point_attractor<real>& force)
+	{
+		wake_all();
+
+		return force_generators.add(force);
 	}
 
-	void world::set_gravity(physics::vec_2d gravity)
+	template <typename real>
+	size_t basic_world<real>::add_force(const physics::basic_drag_force<real>& force)
+	{
+		return force_generators.add(force);
+	}
+
+	template <typename real>
+	size_t basic_world<real>::add_force(const physics::basic_wind_force<real>& force)
+	{
+		wake_all();
+
+		return force_generators.add(force);
+	}
+
+	template <typename real>
+	size_t basic_world<real>::add_force(const physics::basic_anchor_spring<real>& force)
+	{
+		force.body->wake();
+
+		return force_generators.add(force);
+	}
+
+	template <typename real>
+	void basic_world<real>::remove_force(size_t id)
+	{
+		force_generators.remove(id);
+
+		wake_all();
+	}
+
+	template <typename real>
+	void basic_world<real>::set_gravity(physics::vec_2<real> gravity)
 	{
 		this->gravity = gravity;
+
+		wake_all();
 	}
 
-	physics::vec_2d world::get_gravity() const
+	template <typename real>
+	physics::vec_2<real> basic_world<real>::get_gravity() const
 	{
 		return gravity;
 	}
 
-	void world::resolve_collision(physics::collision_manifold& collision, double dt)
+	template <typename real>
+	void basic_world<real>::set_broad_phase(physics::broad_phase_type type)
 	{
-		physics::body* body_a = collision.body_a;
-		physics::body* body_b = collision.body_b;
+		if (type == broad_phase_type)
+			return;
 
-		bool a_static = body_a->type == physics::static_body;
-		bool b_static = body_b->type == physics::static_body;
+		broad_phase_type = type;
+		rebuild_broad_phase();
+	}
 
-		physics::vec_2d origin_a = body_a->position;
-		physics::vec_2d origin_b = body_b->position;
+	template <typename real>
+	physics::broad_phase_type basic_world<real>::get_broad_phase() const
+	{
+		return broad_phase_type;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_grid_cell_size(real cell_size)
+	{
+		grid_cell_size = std::max(cell_size, real(0));
 
-		physics::vec_2d direction = vec_sub(origin_a, origin_b);
+		if (broad_phase_type == physics::broad_phase_type::uniform_grid)
+			static_cast<physics::basic_uniform_grid<real>*>(broad_phase.get())->set_cell_size(grid_cell_size);
+	}
+
+	template <typename real>
+	real basic_world<real>::get_grid_cell_size() const
+	{
+		return grid_cell_size;
+	}
 
-		// If both objects are static, ignore
-		if (a_static && b_static)
+	template <typename real>
+	void basic_world<real>::set_simd_level(physics::simd_level level)
+	{
+		simd_level = std::min(level, physics::get_supported_simd_level());
+	}
+
+	template <typename real>
+	physics::simd_level basic_world<real>::get_simd_level() const
+	{
+		return simd_level;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_skip_unchanged_shapes(bool skip)
+	{
+		skip_unchanged_shapes = skip;
+	}
+
+	template <typename real>
+	bool basic_world<real>::get_skip_unchanged_shapes() const
+	{
+		return skip_unchanged_shapes;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_solver_settings(const physics::contact_solver_settings& settings)
+	{
+		solver_settings = settings;
+	}
+
+	template <typename real>
+	physics::contact_solver_settings basic_world<real>::get_solver_settings() const
+	{
+		return solver_settings;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_sleep_settings(const physics::sleep_settings& settings)
+	{
+		sleep_settings = settings;
+
+		if (!sleep_settings.enabled)
+			wake_all();
+	}
+
+	template <typename real>
+	physics::sleep_settings basic_world<real>::get_sleep_settings() const
+	{
+		return sleep_settings;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_deterministic(bool deterministic)
+	{
+		this->deterministic = deterministic;
+		state_hash = 0;
+
+		// Cached rotations were calculated with the other trigonometry
+		for (physics::basic_body<real>& body : bodies)
 		{
-			return;
+			body.shape_updated = false;
+			storage.shape_dirty[body.index] = 1;
 		}
+	}
+
+	template <typename real>
+	bool basic_world<real>::get_deterministic() const
+	{
+		return deterministic;
+	}
+
+	template <typename real>
+	uint64_t basic_world<real>::get_state_hash() const
+	{
+		return state_hash;
+	}
 
-		// If normal in the wrong directiob, negate
-		if (vec_dot(direction, collision.normal) > 0)
-			collision.normal = vec_mul(collision.normal, -1.0);
+	template <typename real>
+	uint64_t basic_world<real>::calculate_state_hash() const
+	{
+		// FNV-1a over 64-bit words, with the high bits folded down so every bit affects the result
+		uint64_t hash = 0xcbf29ce484222325ull;
+		auto add_word = [&](uint64_t word)
+		{
+			hash ^= word;
+			hash *= 0x100000001b3ull;
+			hash ^= hash >> 32;
+		};
 
-		if (a_static && !b_static)
+		// Float values are widened to double, which is exact, so both precisions hash values the same way
+		auto add_real = [&](real number)
 		{
-			body_b->move(vec_mul(collision.normal, collision.depth));
+			double value = static_cast<double>(number);
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			add_word(bits);
+		};
+
+		for (size_t i = 0; i < storage.size(); i++)
+		{
+			add_word(storage.bodies[i]->id);
+			add_real(storage.position_x[i]);
+			add_real(storage.position_y[i]);
+			add_real(storage.rotation[i]);
+			add_real(storage.velocity_x[i]);
+			add_real(storage.velocity_y[i]);
+			add_real(storage.angular_velocity[i]);
+			add_word(storage.sleep_group[i]);
 		}
-		else if (!a_static && b_static)
+
+		return hash;
+	}
+
+	template <typename real>
+	void basic_world<real>::set_thread_count(size_t thread_count)
+	{
+		thread_pool.set_thread_count(thread_count);
+	}
+
+	template <typename real>
+	void basic_world<real>::set_n_body_settings(const physics::n_body_settings& settings)
+	{
+		n_body_settings = settings;
+	}
+
+	template <typename real>
+	physics::n_body_settings basic_world<real>::get_n_body_settings() const
+	{
+		return n_body_settings;
+	}
+
+	template <typename real>
+	size_t basic_world<real>::get_thread_count() const
+	{
+		return thread_pool.get_thread_count();
+	}
+
+	template <typename real>
+	void basic_world<real>::color_contacts(const std::vector<uint32_t>& contact_indices)
+	{
+		body_colors.assign(storage.size(), 0);
+		contact_colors.resize(contact_indices.size());
+		color_offsets.assign(contact_color_count + 1, 0);
+
+		// Colors that can be assigned before falling back to the serial color
+		const uint64_t parallel_colors = (uint64_t(1) << serial_color) - 1;
+
+		for (size_t i = 0; i < contact_indices.size(); i++)
 		{
-			body_a->move(vec_mul(collision.normal, -collision.depth));
+			physics::basic_body<real>* body_a = contacts[contact_indices[i]].body_a;
+			physics::basic_body<real>* body_b = contacts[contact_indices[i]].body_b;
+
+			bool a_static = !is_awake(body_a);
+			bool b_static = !is_awake(body_b);
+
+			uint64_t used_colors = 0;
+			if (!a_static)
+				used_colors |= body_colors[body_a->index];
+			if (!b_static)
+				used_colors |= body_colors[body_b->index];
+
+			// Pick the lowest color not used by either body
+			uint64_t free_colors = ~used_colors & parallel_colors;
+			uint32_t color = free_colors ? static_cast<uint32_t>(std::countr_zero(free_colors)) : serial_color;
+
+			if (color != serial_color)
+			{
+				if (!a_static)
+					body_colors[body_a->index] |= uint64_t(1) << color;
+				if (!b_static)
+					body_colors[body_b->index] |= uint64_t(1) << color;
+			}
+
+			contact_colors[i] = color;
+			color_offsets[color + 1]++;
 		}
-		else
+
+		// Order contacts by color, keeping the contact order within each color
+		for (uint32_t color = 0; color < contact_color_count; color++)
+			color_offsets[color + 1] += color_offsets[color];
+
+		color_order.resize(contact_indices.size());
+
+		std::array<size_t, contact_color_count> next_index {};
+		std::copy(color_offsets.begin(), color_offsets.end() - 1, next_index.begin());
+
+		for (size_t i = 0; i < contact_indices.size(); i++)
+			color_order[next_index[contact_colors[i]]++] = contact_indices[i];
+	}
+
+	template <typename real>
+	void basic_world<real>::prepare_contacts(real dt)
+	{
+		constraints.resize(contacts.size());
+
+		for (size_t i = 0; i < contacts.size(); i++)
 		{
-			body_a->move(vec_mul(collision.normal, -collision.depth * 0.5));
-			body_b->move(vec_mul(collision.normal, collision.depth * 0.5));	
+			physics::basic_body<real>* body_a = contacts[i].body_a;
+			physics::basic_body<real>* body_b = contacts[i].body_b;
+
+			physics::basic_contact_constraint<real>& constraint = constraints[i];
+			constraint = physics::basic_contact_constraint<real> {};
+
+			constraint.index_a = body_a->index;
+			constraint.index_b = body_b->index;
+
+			// Sleeping bodies touched by resting bodies stay asleep and are treated as static
+			constraint.a_static = !is_awake(body_a);
+			constraint.b_static = !is_awake(body_b);
+
+			if (solver_settings.warm_starting)
+				contact_cache.warm_start(contacts[i], constraint);
 		}
 
-		double restitution = body_a->material.restitution * body_b->material.restitution;
+		size_t chunk_count = (contacts.size() + solver_chunk_size - 1) / solver_chunk_size;
+
+		thread_pool.run(chunk_count, [&](size_t chunk, size_t /*thread*/)
+		{
+			size_t begin = chunk * solver_chunk_size;
+			size_t end = std::min(begin + solver_chunk_size, contacts.size());
+
+			for (size_t i = begin; i < end; i++)
+				physics::prepare_contact(storage, contacts[i], solver_settings, dt, constraints[i]);
+		});
+	}
 
-		double inv_mass_a = body_a->get_inverse_mass();
-		double inv_mass_b = body_b->get_inverse_mass();
+	template <typename real>
+	void basic_world<real>::solve_contacts(real dt)
+	{
+		islands.build(storage, contacts);
 
-		double inv_inertia_a = body_a->get_inv_moment_of_inertia();
-		double inv_inertia_b = body_b->get_inv_moment_of_inertia();
+		prepare_contacts(dt);
 
-		double static_friction = body_a->material.static_friction * body_b->material.static_friction;
-		double kinetic_friction = body_a->material.kinetic_friction * body_b->material.kinetic_friction;
+		small_islands.clear();
+		large_island_contacts.clear();
 
-		// Average contact points
-		size_t num_contacts = collision.contact_points.size();
-		physics::vec_2d contact_point{};
-		for (size_t i = 0; i < num_contacts; i++)
+		for (size_t island = 0; island < islands.get_island_count(); island++)
 		{
-			contact_point = vec_add(contact_point, collision.contact_points[i]);
+			size_t begin = islands.contact_offsets[island];
+			size_t end = islands.contact_offsets[island + 1];
+
+			if (begin == end)
+				continue;
+
+			if (end - begin < large_island_size)
+				small_islands.push_back(island);
+			else
+				large_island_contacts.insert(large_island_contacts.end(), islands.contacts.begin() + begin, islands.contacts.begin() + end);
 		}
 
-		contact_point = vec_div(contact_point, num_contacts);
+		int iterations = std::max(solver_settings.velocity_iterations, 1);
 
-		// Find relative contact points to body origin
-		vec_2d ra = vec_sub(contact_point, origin_a);
-		vec_2d rb = vec_sub(contact_point, origin_b);
+		// Islands don't share dynamic bodies, so each small island is solved as its own task
+		thread_pool.run(small_islands.size(), [&](size_t task, size_t /*thread*/)
+		{
+			size_t island = small_islands[task];
+			size_t begin = islands.contact_offsets[island];
+			size_t end = islands.contact_offsets[island + 1];
+
+			for (size_t i = begin; i < end; i++)
+				physics::warm_start_contact(storage, constraints[islands.contacts[i]]);
 
-		vec_2d ra_perp = { -ra.y, ra.x };
-		vec_2d rb_perp = { -rb.y, rb.x };
+			for (int iteration = 0; iteration < iterations; iteration++)
+			{
+				for (size_t i = begin; i < end; i++)
+					physics::solve_contact(storage, constraints[islands.contacts[i]]);
+			}
+		});
 
-		// Calculate angular velocity vector
-		vec_2d angular_va = vec_mul(ra_perp, body_a->angular_velocity);
-		vec_2d angular_vb = vec_mul(rb_perp, body_b->angular_velocity);
+		// Large islands are split further by coloring their contacts
+		color_contacts(large_island_contacts);
 
-		// Calculate total velocity 
-		vec_2d va = vec_add(body_a->velocity, angular_va);
-		vec_2d vb = vec_add(body_b->velocity, angular_vb);
+		auto solve_colors = [&](auto solve)
+		{
+			for (uint32_t color = 0; color < contact_color_count; color++)
+			{
+				size_t begin = color_offsets[color];
+				size_t end = color_offsets[color + 1];
+
+				if (begin == end)
+					continue;
+
+				if (color == serial_color)
+				{
+					for (size_t i = begin; i < end; i++)
+						solve(constraints[color_order[i]]);
+
+					continue;
+				}
+
+				size_t chunk_count = (end - begin + solver_chunk_size - 1) / solver_chunk_size;
+
+				thread_pool.run(chunk_count, [&](size_t chunk, size_t /*thread*/)
+				{
+					size_t chunk_begin = begin + chunk * solver_chunk_size;
+					size_t chunk_end = std::min(chunk_begin + solver_chunk_size, end);
+
+					for (size_t i = chunk_begin; i < chunk_end; i++)
+						solve(constraints[color_order[i]]);
+				});
+			}
+		};
+
+		solve_colors([&](physics::basic_contact_constraint<real>& constraint) { physics::warm_start_contact(storage, constraint); });
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+			solve_colors([&](physics::basic_contact_constraint<real>& constraint) { physics::solve_contact(storage, constraint); });
+	}
 
-		// Relative velocity between the two bodies
-		vec_2d relative_vel = vec_sub(vb, va);
+	template <typename real>
+	void basic_world<real>::apply_forces()
+	{
+		size_t chunk_count = (storage.size() + integrate_chunk_size - 1) / integrate_chunk_size;
 
-		// Calculate impulse magnitude (from Newcastle University)
-		double j = -(1.0 + restitution) * vec_dot(relative_vel, collision.normal);
-		j /= inv_mass_a + inv_mass_b + inv_inertia_a * square(vec_cross(ra, collision.normal)) + inv_inertia_b * square(vec_cross(rb, collision.normal));
+		thread_pool.run(chunk_count, [&](size_t chunk, size_t /*thread*/)
+		{
+			size_t begin = chunk * integrate_chunk_size;
+			size_t end = std::min(begin + integrate_chunk_size, storage.size());
 
-		// Calculate and apply impulse to both bodies
-		vec_2d impulse = vec_mul(collision.normal, j);
+			force_generators.apply(storage, begin, end);
+		});
+	}
 
-		body_a->velocity = vec_sub(body_a->velocity, vec_mul(impulse, inv_mass_a));
-		body_a->angular_velocity -= inv_inertia_a * vec_cross(ra, impulse);
+	template <typename real>
+	void basic_world<real>::integrate_motion(real dt)
+	{
+		size_t chunk_count = (storage.size() + integrate_chunk_size - 1) / integrate_chunk_size;
 
-		body_b->velocity = vec_add(body_b->velocity, vec_mul(impulse, inv_mass_b));
-		body_b->angular_velocity += inv_inertia_b * vec_cross(rb, impulse);
+		thread_pool.run(chunk_count, [&](size_t chunk, size_t /*thread*/)
+		{
+			size_t begin = chunk * integrate_chunk_size;
+			size_t end = std::min(begin + integrate_chunk_size, storage.size());
 
-		// Calculate tangential vector
-		vec_2d tangent = vec_sub(relative_vel, vec_mul(collision.normal, vec_dot(relative_vel, collision.normal)));
+			physics::integrate_motion(storage, gravity, dt, simd_level, begin, end);
+		});
+	}
 
-		if (vec_equals(tangent, vec_zero))
+	template <typename real>
+	void basic_world<real>::update_sleep(real dt)
+	{
+		if (!sleep_settings.enabled)
 			return;
-		else
-			tangent = vec_normalize(tangent);
 
-		double ra_perp_dot_t = vec_dot(ra_perp, tangent);
-		double rb_perp_dot_t = vec_dot(rb_perp, tangent);
+		// Bodies are at rest while they stay within the distance they would cover at the threshold velocities over the sleep time
+		// Checking displacement rather than instantaneous velocity ignores the jitter of bodies resting on each other
+		real linear_tolerance = static_cast<real>(square(sleep_settings.linear_velocity * sleep_settings.time_to_sleep));
+		real angular_tolerance = static_cast<real>(sleep_settings.angular_velocity * sleep_settings.time_to_sleep);
+		real time_to_sleep = static_cast<real>(sleep_settings.time_to_sleep);
+
+		for (size_t island = 0; island < islands.get_island_count(); island++)
+		{
+			size_t begin = islands.body_offsets[island];
+			size_t end = islands.body_offsets[island + 1];
 
-		// Calculate friction impulse magnitude (from Newcastle University)
-		double j_tangent = -vec_dot(relative_vel, tangent);
-		j_tangent /= inv_mass_a + inv_mass_b + inv_inertia_a * square(ra_perp_dot_t) + inv_inertia_b * square(rb_perp_dot_t);
+			real min_sleep_time = std::numeric_limits<real>::max();
 
-		vec_2d friction_impulse {};
+			for (size_t i = begin; i < end; i++)
+			{
+				uint32_t index = islands.bodies[i];
 
-		if (std::abs(j_tangent) <= j * static_friction) // Apply static friction if the frictional impulse does not overcome it
-			friction_impulse = vec_mul(tangent, j_tangent);
-		else
-			friction_impulse = vec_mul(tangent, -j * kinetic_friction); // Otherwise, apply kinetic friction
+				real displacement = square(storage.position_x[index] - storage.rest_position_x[index]) + square(storage.position_y[index] - storage.rest_position_y[index]);
+				real angular_displacement = std::abs(storage.rotation[index] - storage.rest_rotation[index]);
+
+				// Start resting again from the current transform if the body moved too far
+				if (displacement > linear_tolerance || angular_displacement > angular_tolerance)
+				{
+					storage.sleep_time[index] = 0;
+					storage.rest_position_x[index] = storage.position_x[index];
+					storage.rest_position_y[index] = storage.position_y[index];
+					storage.rest_rotation[index] = storage.rotation[index];
+				}
+				else
+				{
+					storage.sleep_time[index] += dt;
+				}
+
+				min_sleep_time = std::min(min_sleep_time, storage.sleep_time[index]);
+			}
+
+			// The whole island sleeps together so stacks don't wake up piece by piece
+			if (min_sleep_time < time_to_sleep)
+				continue;
+
+			size_t group = ++sleep_group_count;
+
+			for (size_t i = begin; i < end; i++)
+			{
+				uint32_t index = islands.bodies[i];
+
+				storage.sleep_group[index] = group;
+				storage.set_velocity(index, {});
+				storage.angular_velocity[index] = 0;
+				storage.update_motion_mask(index);
+
+				broad_phase->remove(storage.bodies[index]);
+				sleeping_tree.insert(storage.bodies[index]);
+			}
+		}
+	}
+
+	template <typename real>
+	void basic_world<real>::wake_body(size_t index)
+	{
+		if (!storage.is_sleeping(index))
+		{
+			storage.sleep_time[index] = 0;
+			return;
+		}
+
+		woken_groups.push_back(storage.sleep_group[index]);
+		wake_groups();
+	}
 
-		// Apply impusle to both bodies
-		body_a->velocity = vec_sub(body_a->velocity, vec_mul(friction_impulse, inv_mass_a));
-		body_a->angular_velocity -= inv_inertia_a * vec_cross(ra, friction_impulse);
+	template <typename real>
+	void basic_world<real>::wake_groups()
+	{
+		if (woken_groups.empty())
+			return;
+
+		std::sort(woken_groups.begin(), woken_groups.end());
+		woken_groups.erase(std::unique(woken_groups.begin(), woken_groups.end()), woken_groups.end());
+
+		for (size_t i = 0; i < storage.size(); i++)
+		{
+			if (!storage.is_sleeping(i) || !std::binary_search(woken_groups.begin(), woken_groups.end(), storage.sleep_group[i]))
+				continue;
+
+			storage.sleep_group[i] = 0;
+			storage.sleep_time[i] = 0;
+			storage.update_motion_mask(i);
+
+			sleeping_tree.remove(storage.bodies[i]);
+			broad_phase->insert(storage.bodies[i]);
+		}
+
+		woken_groups.clear();
+	}
+
+	template <typename real>
+	void basic_world<real>::wake_overlapping(physics::basic_aabb<real> aabb)
+	{
+		real margin = real(0.1) * std::max(aabb.max.x - aabb.min.x, aabb.max.y - aabb.min.y);
+		aabb.min = { aabb.min.x - margin, aabb.min.y - margin };
+		aabb.max = { aabb.max.x + margin, aabb.max.y + margin };
+
+		// Called between steps, so the static query buffer is free to use
+		static_query_results.clear();
+		sleeping_tree.query(aabb, static_query_results);
+
+		for (physics::basic_body<real>* body : static_query_results)
+			woken_groups.push_back(storage.sleep_group[body->index]);
 
-		body_b->velocity = vec_add(body_b->velocity, vec_mul(friction_impulse, inv_mass_b));
-		body_b->angular_velocity += inv_inertia_b * vec_cross(rb, friction_impulse);
+		wake_groups();
 	}
 
-	void world::step(double time, int substeps)
+	template <typename real>
+	void basic_world<real>::wake_all()
+	{
+		for (size_t i = 0; i < storage.size(); i++)
+		{
+			if (storage.is_sleeping(i))
+			{
+				sleeping_tree.remove(storage.bodies[i]);
+				broad_phase->insert(storage.bodies[i]);
+			}
+
+			storage.sleep_group[i] = 0;
+			storage.sleep_time[i] = 0;
+			storage.update_motion_mask(i);
+		}
+	}
+
+	template <typename real>
+	bool basic_world<real>::is_awake(const physics::basic_body<real>* body) const
+	{
+		return body->type != physics::static_body && !storage.is_sleeping(body->index);
+	}
+
+	template <typename real>
+	void basic_world<real>::step(real time, int substeps)
 	{
 		if (bodies.empty())
 			return;
 
 		// Calculate dt for each substep
-		double dt = time / substeps;
+		real dt = time / substeps;
 
 		// Store performance benchmarks
-		uint64_t collision_detection_time { 0 };
+		uint64_t broad_phase_time { 0 };
+		uint64_t narrow_phase_time { 0 };
 		uint64_t solve_constraints_time { 0 };
 		uint64_t integrate_motion_time { 0 };
+		uint64_t n_body_time { 0 };
+		uint64_t apply_forces_time { 0 };
+		size_t refreshed_shape_count { 0 };
+
+		contact_events.clear();
 
 		// Update world for each substep
 		for (int substep = 0; substep < substeps; substep++)
 		{
 			contacts.clear();
+			pairs.clear();
 			timer.reset();
 
-			for (physics::body& body : bodies)
+			// Sleep groups near static bodies that were added, removed or moved were woken when they changed
+			if (static_tree_changed)
+				rebuild_static_tree();
+
+			for (size_t i = 0; i < storage.size(); i++)
 			{
-				//if (body.type == body_type::static_body)
-				//	continue;
+				// Static body shapes are updated when they are moved, and sleeping bodies don't move
+				if (!is_awake(storage.bodies[i]))
+					continue;
+
+				// Integration and the transform setters flag bodies that moved
+				if (skip_unchanged_shapes && !storage.shape_dirty[i])
+					continue;
 				
 				// Update AABB and cache translated polygon vertices
-				body.update_shape();
+				storage.bodies[i]->update_shape();
+				refreshed_shape_count++;
+			}
+
+			// Find static and sleeping bodies overlapping each awake dynamic body
+			for (size_t i = 0; i < storage.size(); i++)
+			{
+				if (!is_awake(storage.bodies[i]))
+					continue;
+
+				static_query_results.clear();
+				static_tree.query(storage.aabb[i], static_query_results);
+				sleeping_tree.query(storage.aabb[i], static_query_results);
+
+				for (physics::basic_body<real>* other : static_query_results)
+					pairs.push_back(make_body_pair(storage.bodies[i], other));
 			}
 
-			// O(n^2) collision detection
-			// Can be improved with a broad-phase narrow-phase approach
-			for (size_t i = 0; i < bodies.size() - 1; i++)
+			// Find pairs of awake dynamic bodies with overlapping AABBs
+			broad_phase->update();
+			broad_phase->find_pairs(pairs);
+
+			// Contacts are sorted after the narrow phase regardless, this also removes the broad phase's order from everything done with the pairs
+			if (deterministic)
 			{
-				for (size_t j = i + 1; j < bodies.size(); j++)
+				std::sort(pairs.begin(), pairs.end(), [](const physics::basic_body_pair<real>& a, const physics::basic_body_pair<real>& b)
 				{
-					if (i == j)
-						continue;
+					if (a.body_a->id != b.body_a->id)
+						return a.body_a->id < b.body_a->id;
 
-					if (bodies[i].type == body_type::static_body && bodies[j].type == body_type::static_body)
-						continue;
+					return a.body_b->id < b.body_b->id;
+				});
+			}
 
-					// If AABBs do not intersect, there is no chance of collision 
-					// Improves collision detection performance by ~10-20x 
-					if (!physics::aabb_intersection(bodies[i].get_aabb(), bodies[j].get_aabb()))
-					{
+			// Wake sleeping bodies touched by moving bodies
+			// Bodies that are awake but resting don't wake their neighbours, otherwise two resting islands could keep waking each other
+			for (const physics::basic_body_pair<real>& pair : pairs)
+			{
+				bool a_moving = is_awake(pair.body_a) && storage.sleep_time[pair.body_a->index] == 0;
+				bool b_moving = is_awake(pair.body_b) && storage.sleep_time[pair.body_b->index] == 0;
+
+				if (a_moving && storage.is_sleeping(pair.body_b->index))
+					woken_groups.push_back(storage.sleep_group[pair.body_b->index]);
+				else if (b_moving && storage.is_sleeping(pair.body_a->index))
+					woken_groups.push_back(storage.sleep_group[pair.body_a->index]);
+			}
+
+			wake_groups();
+
+			broad_phase_time += timer.elapsed<std::chrono::microseconds>();
+			timer.reset();
+
+			// Test pairs for collision in chunks spread across the worker threads
+			size_t chunk_count = (pairs.size() + narrow_phase_chunk_size - 1) / narrow_phase_chunk_size;
+
+			thread_contacts.resize(thread_pool.get_thread_count());
+			for (std::vector<physics::basic_collision_manifold<real>>& buffer : thread_contacts)
+				buffer.clear();
+
+			thread_pool.run(chunk_count, [&](size_t chunk, size_t thread)
+			{
+				size_t begin = chunk * narrow_phase_chunk_size;
+				size_t end = std::min(begin + narrow_phase_chunk_size, pairs.size());
+
+				for (size_t i = begin; i < end; i++)
+				{
+					// Pairs of sleeping and static bodies can't collide
+					if (!is_awake(pairs[i].body_a) && !is_awake(pairs[i].body_b))
 						continue;
-					}
 
-					// Test for collision between the two bodies
-					physics::collision_manifold collision;
-					if (physics::get_collision(&bodies[i], &bodies[j], collision))
+					// Reuse the previous manifold if neither body has moved, otherwise test for collision between the two bodies
+					physics::basic_collision_manifold<real> collision;
+					if (contact_cache.get_unchanged_collision(pairs[i].body_a, pairs[i].body_b, collision) || physics::get_collision(pairs[i].body_a, pairs[i].body_b, collision))
 					{
-						// If objects are in contact, add to a list of contacts
-						contacts.push_back(collision);
+						// If objects are in contact, add to the thread's list of contacts
+						thread_contacts[thread].push_back(collision);
 					}
 				}
-			}
+			});
+
+			// Merge contacts and sort by body id pair so the order does not depend on the thread count
+			for (std::vector<physics::basic_collision_manifold<real>>& buffer : thread_contacts)
+				contacts.insert(contacts.end(), buffer.begin(), buffer.end());
+
+			std::sort(contacts.begin(), contacts.end(), [](const physics::basic_collision_manifold<real>& a, const physics::basic_collision_manifold<real>& b)
+			{
+				if (a.body_a->id != b.body_a->id)
+					return a.body_a->id < b.body_a->id;
 
-			collision_detection_time += timer.elapsed<std::chrono::microseconds>();
+				return a.body_b->id < b.body_b->id;
+			});
+
+			narrow_phase_time += timer.elapsed<std::chrono::microseconds>();
 			timer.reset();
 
 			// Resolve each collision
-			for (physics::collision_manifold& collision : contacts)
-			{
-				resolve_collision(collision, dt);
-			}
+			solve_contacts(dt);
+			contact_cache.update(pairs, contacts, constraints, contact_events);
 
 			solve_constraints_time += timer.elapsed<std::chrono::microseconds>();
 			timer.reset();
 
-			for (size_t i = 0; i < bodies.size(); i++)
+			// Gravity between bodies is added to the forces integrated next
+			if (n_body_settings.enabled)
 			{
-				physics::body& body = bodies[i];
-
-				double mass = body.get_mass();
-				double inv_mass = body.get_inverse_mass();
+				n_body_gravity.apply(storage, n_body_settings, thread_pool);
 
-				if (body.type == physics::static_body || mass <= 0 || inv_mass <= 0)
-					continue;
-
-				// obj.force * inv_mass
-				physics::vec_2d acceleration{};
-				//std::cout << body.force.x << ", " << body.force.y << "\n";
-				acceleration.x = gravity.x + body.force.x * inv_mass;
-				acceleration.y = gravity.y + body.force.y * inv_mass;
-
-				// Velocity verlet integration
-				body.position.x += body.velocity.x * dt + 0.5 * acceleration.x * dt * dt;
-				body.position.y += body.velocity.y * dt + 0.5 * acceleration.y * dt * dt;
-
-				body.velocity.x += acceleration.x * dt;
-				body.velocity.y += acceleration.y * dt;
+				n_body_time += timer.elapsed<std::chrono::microseconds>();
+				timer.reset();
+			}
 
-				body.rotation += body.angular_velocity * dt;
+			if (!force_generators.empty())
+			{
+				apply_forces();
 
-				body.force = vec_zero;
+				apply_forces_time += timer.elapsed<std::chrono::microseconds>();
+				timer.reset();
 			}
 
+			integrate_motion(dt);
+			update_sleep(dt);
+
 			integrate_motion_time += timer.elapsed<std::chrono::microseconds>();
 		}
 
-		performance_report.collision_detection_time = collision_detection_time / substeps / 1000.0;
+		performance_report.broad_phase_time = broad_phase_time / substeps / 1000.0;
+		performance_report.narrow_phase_time = narrow_phase_time / substeps / 1000.0;
+		performance_report.collision_detection_time = performance_report.broad_phase_time + performance_report.narrow_phase_time;
 		performance_report.solve_constraints_time = solve_constraints_time / substeps / 1000.0;
 		performance_report.integrate_motion_time = integrate_motion_time / substeps / 1000.0;
+		performance_report.n_body_time = n_body_time / substeps / 1000.0;
+		performance_report.apply_forces_time = apply_forces_time / substeps / 1000.0;
+		performance_report.island_count = islands.get_island_count();
+		performance_report.largest_island = islands.get_largest_island();
+		performance_report.refreshed_shape_count = refreshed_shape_count;
+		performance_report.sleeping_body_count = static_cast<size_t>(std::count_if(storage.sleep_group.begin(), storage.sleep_group.end(), [](size_t group) { return group != 0; }));
+
+		if (deterministic)
+			state_hash = calculate_state_hash();
 	}
 
-	physics::performance_report world::get_step_performance() const
+	template <typename real>
+	physics::performance_report basic_world<real>::get_step_performance() const
 	{
 		return performance_report;
 	}
+
+	template class basic_world<float>;
+	template class basic_world<double>;
 }
\ No newline at end of file
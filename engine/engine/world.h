@@ -1,8 +1,19 @@
 #pragma once
 
-#include <deque>
+#include <list>
+#include <memory>
 #include "body.h"
+#include "body_storage.h"
+#include "broad_phase.h"
 #include "collision.h"
+#include "contact_cache.h"
+#include "contact_solver.h"
+#include "dynamic_tree.h"
+#include "force_generator.h"
+#include "integrator.h"
+#include "island.h"
+#include "n_body.h"
+#include "thread_pool.h"
 #include "timer.h"
 
 namespace physics
@@ -10,61 +21,293 @@ namespace physics
 	struct performance_report
 	{
 		double collision_detection_time { 0.0 };
+		double broad_phase_time { 0.0 };
+		double narrow_phase_time { 0.0 };
 		double solve_constraints_time { 0.0 };
 		double integrate_motion_time { 0.0 };
+		double n_body_time { 0.0 };
+		double apply_forces_time { 0.0 };
+
+		// Islands of bodies connected through contacts in the last substep
+		size_t island_count { 0 };
+		size_t largest_island { 0 };
+
+		size_t sleeping_body_count { 0 };
+
+		// Number of body shapes (AABB and world space vertices) updated, summed over the substeps
+		size_t refreshed_shape_count { 0 };
+	};
+
+	struct sleep_settings
+	{
+		bool enabled { true };
+
+		// Bodies moving slower than these velocities on average over the sleep time are at rest
+		double linear_velocity { 0.05 };
+		double angular_velocity { 0.05 };
+
+		// Time every body in an island must be at rest before the island falls asleep
+		double time_to_sleep { 0.5 };
 	};
 
 	const physics::vec_2d default_gravity { 0, -9.8 };
 
-	class world
+	// Physics world, templated on the scalar type of every body, shape and contact in it
+	// Float worlds halve the memory the step streams through and integrate twice as many bodies per SIMD instruction,
+	// at the cost of precision far from the origin and in long stacks
+	template <typename real>
+	class basic_world
 	{
+		friend class physics::basic_body<real>;
+
 	private:
-		physics::vec_2d gravity { default_gravity };
-		std::deque<physics::body> bodies {};
-		std::vector<physics::collision_manifold> contacts {};
+		physics::vec_2<real> gravity { static_cast<real>(physics::default_gravity.x), static_cast<real>(physics::default_gravity.y) };
+
+		// Bodies are kept in a list so pointers to them stay valid when other bodies are removed
+		std::list<physics::basic_body<real>> bodies {};
+
+		// Per-body data used every step, stored as structure-of-arrays
+		physics::basic_body_storage<real> storage {};
+
+		// Contacts of the current substep
+		// This and the other per-step lists are cleared rather than freed, so a world in a steady state doesn't allocate
+		std::vector<physics::basic_collision_manifold<real>> contacts {};
+
+		physics::broad_phase_type broad_phase_type { physics::broad_phase_type::uniform_grid };
+		std::unique_ptr<physics::basic_broad_phase<real>> broad_phase { nullptr };
+		std::vector<physics::basic_body_pair<real>> pairs {};
+
+		// Static bodies are kept out of the broad phase in their own tree
+		// The tree is only rebuilt when a static body is added, removed or moved
+		physics::basic_dynamic_tree<real> static_tree { 0 };
+		std::vector<physics::basic_body<real>*> static_query_results {};
+		bool static_tree_changed { false };
+
+		// Sleeping bodies are moved out of the broad phase into their own tree when they fall asleep and back when they wake
+		// Only awake bodies query it, so sleeping bodies never form pairs with each other
+		physics::basic_dynamic_tree<real> sleeping_tree { 0 };
+
+		// Grid cell size (0 to tune automatically)
+		real grid_cell_size { 0 };
+
+		// Instruction set used by the integrator
+		physics::simd_level simd_level { physics::get_supported_simd_level() };
+
+		// Only update the shapes of bodies flagged as moved since the last substep
+		bool skip_unchanged_shapes { true };
+
+		// Rotations use software trigonometry, broad phase pairs are sorted and the state is hashed after each step
+		bool deterministic { false };
+		uint64_t state_hash { 0 };
+
+		// Worker threads for the parallel parts of the step
+		physics::thread_pool thread_pool {};
+
+		// Contacts found by each thread in the narrow phase, merged into contacts in body id order
+		std::vector<std::vector<physics::basic_collision_manifold<real>>> thread_contacts {};
+
+		// Number of pairs each narrow phase task tests
+		static constexpr size_t narrow_phase_chunk_size = 128;
+
+		// Contacts are colored so no two contacts of the same color share a dynamic body
+		// The last color holds contacts that did not fit in the others and is solved on one thread
+		static constexpr uint32_t contact_color_count = 64;
+		static constexpr uint32_t serial_color = contact_color_count - 1;
+
+		// Number of contacts each solver task resolves
+		static constexpr size_t solver_chunk_size = 64;
+
+		// Number of bodies each integration task integrates
+		static constexpr size_t integrate_chunk_size = 4096;
+
+		// Islands with at least this many contacts are solved with graph coloring instead of as a single task
+		static constexpr size_t large_island_size = 256;
+
+		physics::basic_island_set<real> islands {};
+
+		physics::contact_solver_settings solver_settings {};
+
+		// Solver data for each contact
+		std::vector<physics::basic_contact_constraint<real>> constraints {};
+
+		// Manifolds and impulses of each overlapping pair from the previous step
+		physics::basic_contact_cache<real> contact_cache {};
+
+		// Contacts that began or ended during the last call to step
+		std::vector<physics::basic_contact_event<real>> contact_events {};
+
+		physics::sleep_settings sleep_settings {};
+
+		// Gravity between bodies, applied before integration each substep
+		physics::n_body_settings n_body_settings {};
+		physics::basic_n_body_gravity<real> n_body_gravity {};
+
+		// Forces applied to the bodies before integration each substep
+		physics::basic_force_generator_set<real> force_generators {};
+
+		// Number of sleep groups created (each island that falls asleep becomes a new group)
+		size_t sleep_group_count { 0 };
+
+		// Sleep groups to wake in the next call to wake_groups
+		std::vector<size_t> woken_groups {};
+		std::vector<size_t> small_islands {};
+		std::vector<uint32_t> large_island_contacts {};
+
+		// Colors used by the contacts of each body (indexed by storage slot)
+		std::vector<uint64_t> body_colors {};
+
+		// Color of each contact being colored, contact indices ordered by color, and the start of each color in that list
+		std::vector<uint32_t> contact_colors {};
+		std::vector<uint32_t> color_order {};
+		std::vector<size_t> color_offsets {};
 
 		physics::timer timer;
 		physics::performance_report performance_report;
 
 		size_t body_id { 0 };
 
-		void resolve_collision(physics::collision_manifold& collision, double dt);
+		// Greedily colors the graph of the given contacts, where static and sleeping bodies do not create edges
+		void color_contacts(const std::vector<uint32_t>& contact_indices);
+
+		// Solves contacts with sequential impulses, with each island solved in parallel
+		// Large islands are solved one color at a time, with the contacts of each color solved in parallel
+		void solve_contacts(real dt);
+
+		// Creates a constraint for each contact, warm started from the contact cache
+		void prepare_contacts(real dt);
+
+		// Applies the force generators with the bodies split into chunks across the worker threads
+		void apply_forces();
+
+		// Integrates motion with the bodies split into chunks across the worker threads
+		void integrate_motion(real dt);
+
+		// Puts islands to sleep once all of their bodies have been at rest for long enough
+		void update_sleep(real dt);
+
+		// Wakes the body in a storage slot and the bodies it fell asleep with
+		void wake_body(size_t index);
+
+		// Wakes every body in woken_groups
+		void wake_groups();
+
+		// Wakes the sleep groups of bodies overlapping an AABB
+		// The AABB is expanded slightly since resting bodies are often pushed just out of contact
+		void wake_overlapping(physics::basic_aabb<real> aabb);
+
+		void wake_all();
+
+		// Returns true if the body is dynamic and awake
+		bool is_awake(const physics::basic_body<real>* body) const;
+
+		// Recreates the broad phase and inserts every dynamic body into it
+		void rebuild_broad_phase();
+
+		// Rebuilds the static body tree
+		void rebuild_static_tree();
+
+		// Hashes the id, transform, velocity and sleep state of every body
+		uint64_t calculate_state_hash() const;
+
+		// Called by bodies when a static body is moved or a body changes type, with the body's AABB before and after
+		void on_body_changed(const physics::basic_aabb<real>& old_aabb, const physics::basic_aabb<real>& new_aabb, bool type_changed);
 
 	public:
-		world() = default;
-		world(physics::vec_2d gravity);
-		world(world const&) = delete;
-		world& operator=(world const&) = delete;
+		basic_world();
+		basic_world(physics::vec_2<real> gravity);
+		basic_world(basic_world const&) = delete;
+		basic_world& operator=(basic_world const&) = delete;
 
 		// Create a body in the physics world
 		// Only valid way to create a body
-		physics::body* create_body(shape_ptr shape, physics::material material, physics::body_type type, physics::vec_2d position = {}, double rotation = 0.0);
+		physics::basic_body<real>* create_body(physics::basic_shape_ptr<real> shape, physics::basic_material<real> material, physics::body_type type, physics::vec_2<real> position = {}, real rotation = 0);
 
 		// Removes a body from the physics world
-		void remove_body(physics::body* obj);
+		void remove_body(physics::basic_body<real>* obj);
 
-		// Removes all bodies from the world
+		// Removes all bodies and force generators from the world
 		// Invaldiates all pointers to bodies in the world
 		void clear();
 
+		// Add a force generator to the world, returns an id used to remove it
+		// Springs are removed along with their body
+		size_t add_force(const physics::basic_uniform_force<real>& force);
+		size_t add_force(const physics::basic_point_attractor<real>& force);
+		size_t add_force(const physics::basic_drag_force<real>& force);
+		size_t add_force(const physics::basic_wind_force<real>& force);
+		size_t add_force(const physics::basic_anchor_spring<real>& force);
+
+		// Removes a force generator from the world
+		void remove_force(size_t id);
+
 		// Set the physics world's gravity
-		void set_gravity(physics::vec_2d gravity);
+		void set_gravity(physics::vec_2<real> gravity);
+
+		physics::vec_2<real> get_gravity() const;
+
+		// Set the broad-phase algorithm used to find potentially colliding pairs
+		void set_broad_phase(physics::broad_phase_type type);
+		physics::broad_phase_type get_broad_phase() const;
+
+		// Set the uniform grid cell size in world units
+		// A cell size of 0 tunes the cell size automatically from the median body size
+		void set_grid_cell_size(real cell_size);
+		real get_grid_cell_size() const;
+
+		// Set the instruction set used to integrate motion (clamped to what the CPU supports)
+		void set_simd_level(physics::simd_level level);
+		physics::simd_level get_simd_level() const;
 
-		physics::vec_2d get_gravity() const;
+		// Set whether only bodies flagged as moved since the last substep update their AABB and world space vertices
+		void set_skip_unchanged_shapes(bool skip);
+		bool get_skip_unchanged_shapes() const;
+
+		// Set the number of velocity iterations and other contact solver settings
+		void set_solver_settings(const physics::contact_solver_settings& settings);
+		physics::contact_solver_settings get_solver_settings() const;
+
+		// Set when and whether resting bodies fall asleep
+		void set_sleep_settings(const physics::sleep_settings& settings);
+		physics::sleep_settings get_sleep_settings() const;
+
+		// Set whether bodies attract each other and how the attraction is approximated
+		void set_n_body_settings(const physics::n_body_settings& settings);
+		physics::n_body_settings get_n_body_settings() const;
+
+		// Set whether the world is stepped deterministically, so identical worlds stay bit-identical across platforms and compilers
+		// Requires strict floating point with no fused multiply-add contraction or x87 arithmetic
+		// The engine project sets /fp:strict in every configuration, other builds must set the equivalent (e.g. -ffp-contract=off with SSE2)
+		void set_deterministic(bool deterministic);
+		bool get_deterministic() const;
+
+		// Get a hash of the state of every body after the last step in deterministic mode (0 otherwise)
+		// Lockstep clients can compare hashes to detect when their simulations diverge
+		uint64_t get_state_hash() const;
+
+		// Set the number of threads used to step the world (0 to use every hardware thread)
+		// Results are identical for any thread count
+		void set_thread_count(size_t thread_count);
+		size_t get_thread_count() const;
 
 		// Update the physics world over a discrete timestep
-		void step(double time, int substeps);
+		void step(real time, int substeps);
 
 		// Returns a performance report from the previous world step 
 		physics::performance_report get_step_performance() const;
 
-		std::vector<physics::collision_manifold> get_contacts() const;
+		std::vector<physics::basic_collision_manifold<real>> get_contacts() const;
+
+		// Get the contacts that began or ended during the last step, ordered by body id pair within each substep
+		const std::vector<physics::basic_contact_event<real>>& get_contact_events() const;
 
 		// Retrieves all bodies in the physics world
 		// Used for debug and demo purposes
-		std::vector<physics::body*> get_body_ptrs();
+		std::vector<physics::basic_body<real>*> get_body_ptrs();
 
 		// Get the number of bodies in the physics world
 		size_t get_body_count() const;
 	};
+
+	using world = basic_world<double>;
+	using worldf = basic_world<float>;
 }
\ No newline at end of file